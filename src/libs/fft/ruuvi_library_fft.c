@@ -0,0 +1,253 @@
+// See header file for copyright etc.
+
+#include "ruuvi_library_fft.h"
+#include <math.h>
+
+#define PI (3.14159265358979323846) //!< M_PI is not part of C11.
+
+static bool length_is_valid (const size_t length)
+{
+    return (4U <= length) && (0U == (length & (length - 1U)));
+}
+
+/**
+ * @brief Squared magnitude of bin k of packed spectrum, 0 <= k <= length / 2.
+ */
+static float bin_power (const float * const spectrum, const size_t length, const size_t k)
+{
+    float power;
+
+    if (0U == k)
+    {
+        power = spectrum[0] * spectrum[0];
+    }
+    else if ( (length / 2U) == k)
+    {
+        power = spectrum[1] * spectrum[1];
+    }
+    else
+    {
+        power = (spectrum[2U * k] * spectrum[2U * k])
+                + (spectrum[ (2U * k) + 1U] * spectrum[ (2U * k) + 1U]);
+    }
+
+    return power;
+}
+
+/**
+ * @brief Transform interleaved complex data of points samples in place.
+ *
+ * Radix-2 decimation in time. Twiddle k of points / 2 is cos, -sin of 2 pi k / points,
+ * stage of half length butterflies uses every points / (2 * half):th of them.
+ */
+static void complex_transform (const float * const twiddles, float * const data,
+                               const size_t points)
+{
+    for (size_t ii = 0, jj = 0; ii < points; ii++)
+    {
+        if (ii < jj)
+        {
+            const float real = data[2U * ii];
+            const float imag = data[ (2U * ii) + 1U];
+            data[2U * ii] = data[2U * jj];
+            data[ (2U * ii) + 1U] = data[ (2U * jj) + 1U];
+            data[2U * jj] = real;
+            data[ (2U * jj) + 1U] = imag;
+        }
+
+        // Increment jj in bit-reversed order.
+        size_t bit = points >> 1U;
+
+        while (jj & bit)
+        {
+            jj ^= bit;
+            bit >>= 1U;
+        }
+
+        jj |= bit;
+    }
+
+    for (size_t half = 1U; half < points; half *= 2U)
+    {
+        const size_t stride = points / (2U * half);
+
+        for (size_t start = 0; start < points; start += 2U * half)
+        {
+            for (size_t kk = 0; kk < half; kk++)
+            {
+                const float w_real = twiddles[2U * kk * stride];
+                const float w_imag = twiddles[ (2U * kk * stride) + 1U];
+                float * const a = &data[2U * (start + kk)];
+                float * const b = &data[2U * (start + kk + half)];
+                const float t_real = (w_real * b[0]) - (w_imag * b[1]);
+                const float t_imag = (w_real * b[1]) + (w_imag * b[0]);
+                b[0] = a[0] - t_real;
+                b[1] = a[1] - t_imag;
+                a[0] += t_real;
+                a[1] += t_imag;
+            }
+        }
+    }
+}
+
+rl_status_t rl_fft_init (const rl_fft_t * const fft)
+{
+    if (NULL == fft || NULL == fft->twiddles) { return RL_ERROR_NULL; }
+
+    if (!length_is_valid (fft->length)) { return RL_ERROR_DATA_LENGTH; }
+
+    const size_t points = fft->length / 2U;
+
+    // Twiddles of complex transform of points samples.
+    for (size_t kk = 0; kk < (points / 2U); kk++)
+    {
+        const double angle = (2.0 * PI * (double) kk) / (double) points;
+        fft->twiddles[2U * kk] = (float) cos (angle);
+        fft->twiddles[ (2U * kk) + 1U] = (float) -sin (angle);
+    }
+
+    // Twiddles of real split, of length samples.
+    for (size_t kk = 0; kk < (fft->length / 4U); kk++)
+    {
+        const double angle = (2.0 * PI * (double) kk) / (double) fft->length;
+        fft->twiddles[points + (2U * kk)] = (float) cos (angle);
+        fft->twiddles[points + (2U * kk) + 1U] = (float) -sin (angle);
+    }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_fft_real (const rl_fft_t * const fft, float * const data)
+{
+    if (NULL == fft || NULL == fft->twiddles || NULL == data) { return RL_ERROR_NULL; }
+
+    if (!length_is_valid (fft->length)) { return RL_ERROR_DATA_LENGTH; }
+
+    const size_t points = fft->length / 2U;
+    const float * const split = &fft->twiddles[points];
+    // Even samples are real and odd samples imaginary parts of z.
+    complex_transform (fft->twiddles, data, points);
+    // Split Z into spectra of even and odd samples, X[k] = E[k] + W^k O[k],
+    // X[points - k] = conj (E[k] - W^k O[k]).
+    const float dc = data[0];
+    data[0] = dc + data[1];
+    data[1] = dc - data[1];
+
+    for (size_t kk = 1U; kk < (points / 2U); kk++)
+    {
+        float * const low = &data[2U * kk];
+        float * const high = &data[2U * (points - kk)];
+        const float even_real = 0.5F * (low[0] + high[0]);
+        const float even_imag = 0.5F * (low[1] - high[1]);
+        const float odd_real = 0.5F * (low[1] + high[1]);
+        const float odd_imag = 0.5F * (high[0] - low[0]);
+        const float w_real = split[2U * kk];
+        const float w_imag = split[ (2U * kk) + 1U];
+        const float t_real = (w_real * odd_real) - (w_imag * odd_imag);
+        const float t_imag = (w_real * odd_imag) + (w_imag * odd_real);
+        low[0] = even_real + t_real;
+        low[1] = even_imag + t_imag;
+        high[0] = even_real - t_real;
+        high[1] = t_imag - even_imag;
+    }
+
+    // Bin points / 2 pairs with itself, X = conj (Z).
+    data[points + 1U] = -data[points + 1U];
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_fft_power (const float * const spectrum, const size_t length,
+                          float * const power)
+{
+    if (NULL == spectrum || NULL == power) { return RL_ERROR_NULL; }
+
+    if (!length_is_valid (length)) { return RL_ERROR_DATA_LENGTH; }
+
+    // Bins above DC are mirrored to negative frequencies, count them twice.
+    const float scale = 1.0F / ( (float) length * (float) length);
+    const float nyquist = bin_power (spectrum, length, length / 2U);
+    power[0] = bin_power (spectrum, length, 0) * scale;
+
+    // Power k is written before spectrum 2k is read, so buffers may be the same.
+    for (size_t kk = 1U; kk < (length / 2U); kk++)
+    {
+        power[kk] = 2.0F * bin_power (spectrum, length, kk) * scale;
+    }
+
+    power[length / 2U] = nyquist * scale;
+    return RL_SUCCESS;
+}
+
+float rl_fft_band_energy (const float * const spectrum, const size_t length,
+                          const float sample_rate, const float low_hz, const float high_hz)
+{
+    if (NULL == spectrum || !length_is_valid (length) || !isfinite (sample_rate)
+            || !(0.0F < sample_rate) || !(low_hz <= high_hz))
+    {
+        return NAN;
+    }
+
+    const float bin_width = sample_rate / (float) length;
+    float energy = 0.0F;
+
+    for (size_t kk = 0; kk <= (length / 2U); kk++)
+    {
+        const float frequency = (float) kk * bin_width;
+
+        if ( (low_hz <= frequency) && (frequency < high_hz))
+        {
+            const bool mirrored = (0U != kk) && ( (length / 2U) != kk);
+            energy += (mirrored ? 2.0F : 1.0F) * bin_power (spectrum, length, kk);
+        }
+    }
+
+    energy /= (float) length * (float) length;
+    return isfinite (energy) ? energy : NAN;
+}
+
+float rl_fft_dominant_frequency (const float * const spectrum, const size_t length,
+                                 const float sample_rate)
+{
+    if (NULL == spectrum || !length_is_valid (length) || !isfinite (sample_rate)
+            || !(0.0F < sample_rate))
+    {
+        return NAN;
+    }
+
+    const size_t last = length / 2U;
+    size_t peak = 0;
+    float peak_power = 0.0F;
+
+    for (size_t kk = 1U; kk <= last; kk++)
+    {
+        const float power = bin_power (spectrum, length, kk);
+
+        if (!isfinite (power)) { return NAN; }
+
+        if (power > peak_power)
+        {
+            peak = kk;
+            peak_power = power;
+        }
+    }
+
+    if (0U == peak) { return NAN; }
+
+    float offset = 0.0F;
+
+    // DC is usually offset rather than leakage of the peak, don't interpolate with it.
+    if ( (1U < peak) && (last > peak))
+    {
+        const float before = sqrtf (bin_power (spectrum, length, peak - 1U));
+        const float center = sqrtf (peak_power);
+        const float after = sqrtf (bin_power (spectrum, length, peak + 1U));
+        const float curvature = before - (2.0F * center) + after;
+
+        if (0.0F > curvature)
+        {
+            offset = 0.5F * (before - after) / curvature;
+        }
+    }
+
+    return ( (float) peak + offset) * sample_rate / (float) length;
+}
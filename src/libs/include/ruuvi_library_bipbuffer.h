@@ -0,0 +1,179 @@
+/**
+ * @file ruuvi_library_bipbuffer.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Ringbuffer of variable-length records with contiguous storage.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Companion of @ref rl_ringbuffer_t for records of varying length. Records are
+ * stored back-to-back with a length prefix, so small events don't take the space
+ * of the largest record. A record never wraps around the end of storage: if it
+ * doesn't fit in the end, the writer continues from start of storage and marks the
+ * end of valid data with a watermark (bip-buffer). Every record is therefore
+ * returned as one contiguous pointer.
+ *
+ * Locking follows @ref rl_ringbuffer_t: NULL lock function selects lock-free
+ * single-producer, single-consumer mode.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_BIPBUFFER_H
+#define  RUUVI_LIBRARY_BIPBUFFER_H
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RL_BIPBUFFER_ALIGN
+#   define RL_BIPBUFFER_ALIGN (4U) //!< Alignment of records, power of two.
+#endif
+/// @cond 0
+#if (RL_BIPBUFFER_ALIGN < 4U)
+#   error "RL_BIPBUFFER_ALIGN must hold uint32_t length prefix"
+#endif
+/// @endcond
+#define RL_BIPBUFFER_HEADER_SIZE (RL_BIPBUFFER_ALIGN) //!< Bytes taken by record length prefix.
+
+/**
+ * @brief Bytes of storage taken by a record of given length.
+ */
+#define RL_BIPBUFFER_RECORD_SIZE(data_length) (RL_BIPBUFFER_HEADER_SIZE + \
+        (((data_length) + RL_BIPBUFFER_ALIGN - 1U) & ~((size_t) RL_BIPBUFFER_ALIGN - 1U)))
+
+/* @brief Struct definition for record buffer.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static uint32_t buffer_data[256];
+ * static rl_bipbuffer_t bipbuf = {.storage_size = sizeof(buffer_data),
+ *                                 .storage = buffer_data,
+ *                                 .lock = NULL,
+ *                                 .writelock = NULL,
+ *                                 .readlock  = NULL};
+ * rl_bipbuffer_init(&bipbuf);
+ * \endcode
+ */
+typedef struct
+{
+    _Atomic size_t head;       //!< Write offset in bytes, written only by producer.
+    _Atomic size_t tail;       //!< Read offset in bytes, written only by consumer.
+    _Atomic size_t watermark;  //!< End of valid data after head has wrapped to start.
+    size_t reserved;           //!< Offset of record reserved by producer.
+    const size_t storage_size; //!< Size of storage in bytes, multiple of RL_BIPBUFFER_ALIGN.
+    void * const storage;      //!< Pointer to storage, aligned to RL_BIPBUFFER_ALIGN.
+    /** @brief Function pointer to lock buffer, see @ref rl_ringbuffer_t.
+     *         NULL selects lock-free single-producer, single-consumer mode.
+     */
+    const rl_atomic_flag lock;
+    volatile void * const writelock;    //!< Memory address for flag locking write function
+    volatile void * const readlock;     //!< Memory address for flag locking read function.
+} rl_bipbuffer_t;
+
+/**
+ * @brief Reset buffer to empty state.
+ *
+ * Must be called before first use and must not be called while buffer is in use.
+ *
+ * @param[in,out] buffer Buffer to initialize.
+ * @retval RL_SUCCESS Buffer was initialized.
+ * @retval RL_ERROR_NULL Buffer or its storage is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Storage size is not a multiple of RL_BIPBUFFER_ALIGN.
+ */
+rl_status_t rl_bipbuffer_init (rl_bipbuffer_t * const buffer);
+
+/**
+ * @brief Reserve contiguous room for a record to write it in place.
+ *
+ * The record becomes visible to consumer only after @ref rl_bipbuffer_commit.
+ * Write lock is held from successful reservation until commit.
+ *
+ * @param[in,out] buffer Buffer to reserve record from.
+ * @param[in]     data_length Length of the record in bytes.
+ * @param[out]    data Pointer to data, will be assigned at the start of the record.
+ * @retval    RL_SUCCESS Record was reserved, must be followed by exactly one commit.
+ * @retval    RL_ERROR_NO_MEM There is no contiguous room for the record.
+ * @retval    RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval    RL_ERROR_FATAL Lock could not be released after failed reservation.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ * @retval    RL_ERROR_DATA_LENGTH Record can never fit into the buffer.
+ */
+rl_status_t rl_bipbuffer_reserve (rl_bipbuffer_t * const buffer,
+                                  const size_t data_length,
+                                  void * const data);
+
+/**
+ * @brief Publish record reserved with @ref rl_bipbuffer_reserve.
+ *
+ * @param[in,out] buffer Buffer which has a reserved record.
+ * @retval    RL_SUCCESS Record was published.
+ * @retval    RL_ERROR_INTERNAL There was no reserved record.
+ * @retval    RL_ERROR_FATAL Lock could not be released.
+ * @retval    RL_ERROR_NULL  Buffer is NULL.
+ */
+rl_status_t rl_bipbuffer_commit (rl_bipbuffer_t * const buffer);
+
+/**
+ * @brief Queue a record into buffer.
+ *
+ * @param[in] buffer Pointer to buffer to store data into
+ * @param[in] data Data to store
+ * @param[in] data_length length of data.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_NO_MEM There is no contiguous room for the record.
+ * @retval    RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval    RL_ERROR_FATAL Lock could not be released.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ * @retval    RL_ERROR_DATA_LENGTH Record can never fit into the buffer.
+ */
+rl_status_t rl_bipbuffer_queue (rl_bipbuffer_t * const buffer,
+                                const void * const data,
+                                const size_t data_length);
+
+/**
+ * @brief Peek oldest record in buffer.
+ *
+ * @param[in,out] buffer Pointer to buffer to peek data from
+ * @param[out]    data Pointer to data, will be assigned at the start of the record.
+ * @param[out]    data_length Length of the record.
+ * @retval        RL_SUCCESS Data was peeked.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_NO_DATA The buffer was empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ */
+rl_status_t rl_bipbuffer_peek (rl_bipbuffer_t * const buffer,
+                               void * const data,
+                               size_t * const data_length);
+
+/**
+ * @brief Dequeue oldest record from buffer.
+ *
+ * Returns pointer to stored data, does not copy it.
+ *
+ * @param[in,out] buffer Pointer to buffer to load data from
+ * @param[out]    data Pointer to data, will be assigned at the start of the record.
+ * @param[out]    data_length Length of the record.
+ * @retval        RL_SUCCESS Data was dequeued.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_NO_DATA The buffer was empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ * @warning       Data returned by this function can be overwritten, peek and dequeue
+ *                after processing if producer runs concurrently.
+ */
+rl_status_t rl_bipbuffer_dequeue (rl_bipbuffer_t * const buffer,
+                                  void * const data,
+                                  size_t * const data_length);
+
+/*
+ * return true if buffer is empty
+ */
+bool rl_bipbuffer_empty (const rl_bipbuffer_t * const buffer);
+
+/*@}*/
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file ruuvi_library_fft.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Real-input FFT and spectral features of a signal sample.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Transform a window of real samples, such as accelerometer readings, to a
+ * spectrum in place and find band energies and dominant frequency on device.
+ *
+ * Length N must be a power of two. The N real samples are treated as N / 2 complex
+ * samples which are transformed with an iterative radix-2 FFT and split into the
+ * spectrum of the real signal. Twiddle factors are calculated once at init into
+ * caller-provided storage of @ref RL_FFT_TWIDDLES floats, so RAM used by a
+ * transform of N samples is 2 * N floats including the samples, with no heap or stack
+ * buffers.
+ *
+ * Spectrum is packed into the N floats of the samples:
+ *  - spectrum[0] is real bin 0, DC.
+ *  - spectrum[1] is real bin N / 2, Nyquist frequency.
+ *  - spectrum[2k] and spectrum[2k + 1] are real and imaginary part of bin k,
+ *    1 <= k < N / 2.
+ *
+ * Bin k is at k * sample rate / N Hz. The transform is not normalized, bin k is
+ * sum of x[n] * exp(-2 pi i k n / N). Samples are not windowed, apply a window
+ * before the transform if leakage between bins matters.
+ */
+
+#ifndef RUUVI_LIBRARY_FFT_H
+#define RUUVI_LIBRARY_FFT_H
+#include "ruuvi_library.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+/// @cond 0
+#ifndef NAN
+#   error "NAN is not defined"
+#endif
+/// @endcond
+
+/** @ingroup analysis
+ *  @{
+ */
+
+/** @brief Number of floats in twiddle storage for transform of given length. */
+#define RL_FFT_TWIDDLES(length) (length)
+
+/**
+ * @brief Transform of fixed length, initialize with @ref rl_fft_init.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static float twiddles[RL_FFT_TWIDDLES(1024)];
+ * static rl_fft_t fft = {.length = 1024, .twiddles = twiddles};
+ * rl_fft_init(&fft);
+ * \endcode
+ */
+typedef struct
+{
+    const size_t length;    //!< Number of real samples, power of two and at least 4.
+    float * const twiddles; //!< Storage for RL_FFT_TWIDDLES(length) floats.
+} rl_fft_t;
+
+/**
+ * @brief Calculate twiddle factors of transform.
+ *
+ * @param[in,out] fft Transform to initialize.
+ * @retval RL_SUCCESS Transform was initialized.
+ * @retval RL_ERROR_NULL Transform or twiddle storage is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Length is not a power of two, or is less than 4.
+ */
+rl_status_t rl_fft_init (const rl_fft_t * const fft);
+
+/**
+ * @brief Transform real samples to packed spectrum in place.
+ *
+ * NAN and infinite samples make the whole spectrum non-finite.
+ *
+ * @param[in]     fft Initialized transform.
+ * @param[in,out] data Length samples in, packed spectrum out.
+ * @retval RL_SUCCESS Data was transformed.
+ * @retval RL_ERROR_NULL Transform, its twiddles or data is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Length is not a power of two, or is less than 4.
+ */
+rl_status_t rl_fft_real (const rl_fft_t * const fft, float * const data);
+
+/**
+ * @brief Calculate one-sided power spectrum from packed spectrum.
+ *
+ * Power of bin k is its share of mean square of the samples, so powers of bins
+ * 0 ... N / 2 sum to square of @ref rl_rms of the samples.
+ *
+ * @param[in]  spectrum Packed spectrum of length floats.
+ * @param[in]  length Number of samples transformed.
+ * @param[out] power Length / 2 + 1 powers, may be the same buffer as spectrum.
+ * @retval RL_SUCCESS Power was calculated.
+ * @retval RL_ERROR_NULL Spectrum or power is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Length is not a power of two, or is less than 4.
+ */
+rl_status_t rl_fft_power (const float * const spectrum, const size_t length,
+                          float * const power);
+
+/**
+ * @brief Calculate energy of samples in frequency band.
+ *
+ * Energy is mean square of the samples within bins of low_hz <= frequency < high_hz.
+ * Band from 0 Hz to above Nyquist frequency gives square of @ref rl_rms, and
+ * bands which share an edge don't count the same bin twice.
+ *
+ * @param[in] spectrum Packed spectrum of length floats.
+ * @param[in] length Number of samples transformed.
+ * @param[in] sample_rate Sample rate in Hz.
+ * @param[in] low_hz Lowest frequency of band.
+ * @param[in] high_hz Frequency above band, may be INFINITY.
+ * @return Energy in band, NAN if input parameters are invalid or spectrum is not finite.
+ */
+float rl_fft_band_energy (const float * const spectrum, const size_t length,
+                          const float sample_rate, const float low_hz, const float high_hz);
+
+/**
+ * @brief Find frequency with most power, excluding DC.
+ *
+ * Strongest bin is refined with parabolic interpolation over magnitudes of its
+ * neighbours, so a tone between bins is found within a fraction of bin width.
+ *
+ * @param[in] spectrum Packed spectrum of length floats.
+ * @param[in] length Number of samples transformed.
+ * @param[in] sample_rate Sample rate in Hz.
+ * @return Dominant frequency in Hz, NAN if input parameters are invalid, spectrum is
+ *         not finite or it has no power above DC.
+ */
+float rl_fft_dominant_frequency (const float * const spectrum, const size_t length,
+                                 const float sample_rate);
+
+/** @} */ // End of group analysis
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file ruuvi_library_moments.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Streaming accumulator of mean, variance and RMS with merge.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Accumulate statistics of an unbounded stream in constant memory, without keeping
+ * the samples as @ref rl_variance needs. Single samples are added with Welford's
+ * update, blocks and partial accumulators are combined with Chan's parallel
+ * formula, so accumulators of different threads or blocks merge to the same
+ * result as one accumulator over all samples, up to rounding.
+ *
+ * Mean and sum of squared deviations are kept in double so that increments of a
+ * long stream are not lost. On MCUs without a double precision FPU this uses
+ * software floating point.
+ */
+
+#ifndef RUUVI_LIBRARY_MOMENTS_H
+#define RUUVI_LIBRARY_MOMENTS_H
+#include "ruuvi_library.h"
+#include "ruuvi_library_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** @ingroup analysis
+ *  @{
+ */
+
+/**
+ * @brief State of streaming accumulator, initialize with @ref rl_moments_init.
+ */
+typedef struct
+{
+    uint64_t count; //!< Number of samples.
+    double mean;    //!< Mean of samples.
+    double m2;      //!< Sum of squared differences from mean.
+    float min;      //!< Smallest sample.
+    float max;      //!< Largest sample.
+    bool finite;    //!< False once a NAN or infinite sample has been added.
+} rl_moments_t;
+
+/**
+ * @brief Reset accumulator to empty state.
+ *
+ * @param[out] moments Accumulator to reset.
+ * @retval RL_SUCCESS Accumulator was reset.
+ * @retval RL_ERROR_NULL Accumulator is NULL.
+ */
+rl_status_t rl_moments_init (rl_moments_t * const moments);
+
+/**
+ * @brief Add one sample.
+ *
+ * A NAN or infinite sample makes every result NAN, like with @ref rl_rms.
+ *
+ * @param[in,out] moments Accumulator to update.
+ * @param[in]     value Sample to add.
+ * @retval RL_SUCCESS Sample was added.
+ * @retval RL_ERROR_NULL Accumulator is NULL.
+ */
+rl_status_t rl_moments_push (rl_moments_t * const moments, const float value);
+
+/**
+ * @brief Add a block of samples.
+ *
+ * Block is reduced with vectorized two-pass kernels and merged into accumulator,
+ * which is faster and more accurate than pushing samples one by one.
+ *
+ * @param[in,out] moments Accumulator to update.
+ * @param[in]     data Samples to add.
+ * @param[in]     data_length Number of samples, 0 is allowed.
+ * @retval RL_SUCCESS Samples were added.
+ * @retval RL_ERROR_NULL Accumulator or data is NULL.
+ */
+rl_status_t rl_moments_push_n (rl_moments_t * const moments, const float * const data,
+                               const size_t data_length);
+
+/**
+ * @brief Add samples of another accumulator.
+ *
+ * @param[in,out] target Accumulator to update.
+ * @param[in]     source Accumulator to add, not modified.
+ * @retval RL_SUCCESS Accumulators were merged.
+ * @retval RL_ERROR_NULL Target or source is NULL.
+ */
+rl_status_t rl_moments_merge (rl_moments_t * const target,
+                              const rl_moments_t * const source);
+
+/**
+ * @brief Calculate statistics of accumulated samples.
+ *
+ * Variance is population variance, as @ref rl_variance.
+ *
+ * @param[in]  moments Accumulator to read.
+ * @param[out] stats Statistics of samples, every field NAN if function fails.
+ * @retval RL_SUCCESS Statistics were calculated.
+ * @retval RL_ERROR_NULL Moments or stats is NULL.
+ * @retval RL_ERROR_NO_DATA Accumulator is empty or has NAN or infinite samples.
+ */
+rl_status_t rl_moments_finalize (const rl_moments_t * const moments,
+                                 rl_stats_t * const stats);
+
+/** @} */ // End of group analysis
+#endif
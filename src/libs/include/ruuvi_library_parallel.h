@@ -0,0 +1,157 @@
+/**
+ * @file ruuvi_library_parallel.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Worker pool and multi-threaded reductions of large sample arrays.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * For offline analysis of long recordings. Input is split into one contiguous
+ * chunk per worker and per calling thread, each chunk is reduced into a
+ * @ref rl_moments_t and the partial results are merged. Workers are started once
+ * in @ref rl_parallel_init and sleep between jobs.
+ *
+ * Results are as accurate as @ref rl_moments_push_n over the whole array. They
+ * differ from the serial float functions by the rounding of the serial sums, at
+ * most n * FLT_EPSILON relative to the result for RMS and variance. Min, max and
+ * peak to peak are exact.
+ *
+ * Requires POSIX threads, enable with RL_PARALLEL_ENABLED.
+ */
+
+#ifndef RUUVI_LIBRARY_PARALLEL_H
+#define RUUVI_LIBRARY_PARALLEL_H
+#include "ruuvi_library.h"
+#include "ruuvi_library_enabled_modules.h"
+#include "ruuvi_library_moments.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if RL_PARALLEL_ENABLED || DOXYGEN
+#include <pthread.h>
+
+#ifndef RL_PARALLEL_MAX_WORKERS
+/** @brief Maximum number of worker threads in a pool. */
+#   define RL_PARALLEL_MAX_WORKERS (16U)
+#endif
+
+/** @ingroup analysis
+ *  @{
+ */
+
+/**
+ * @brief Task run for every part of a job.
+ *
+ * @param[in] context Context given to @ref rl_parallel_run.
+ * @param[in] part Index of part, 0 ... parts - 1.
+ * @param[in] parts Number of parts in job, workers + 1.
+ */
+typedef void (*rl_parallel_task_fp) (void * const context, const size_t part,
+                                     const size_t parts);
+
+/**
+ * @brief Worker pool, initialize with @ref rl_parallel_init.
+ */
+typedef struct
+{
+    pthread_t threads[RL_PARALLEL_MAX_WORKERS]; //!< Worker threads.
+    size_t workers;                             //!< Number of started workers.
+    pthread_mutex_t mutex;                      //!< Protects job state below.
+    pthread_cond_t start;                       //!< Signaled when a job is posted.
+    pthread_cond_t done;                        //!< Signaled when last worker finishes.
+    uint32_t generation;                        //!< Incremented for every job.
+    size_t next_part;                           //!< Next part claimed by a worker.
+    size_t pending;                             //!< Workers still running current job.
+    bool stop;                                  //!< Workers exit when set.
+    rl_parallel_task_fp task;                   //!< Task of current job.
+    void * context;                             //!< Context of current job.
+} rl_parallel_pool_t;
+
+/**
+ * @brief Start worker threads.
+ *
+ * @param[out] pool Pool to initialize.
+ * @param[in]  workers Number of worker threads, 0 runs jobs in calling thread only.
+ *                     Typically number of cores - 1, as caller works too.
+ * @retval RL_SUCCESS Pool was started.
+ * @retval RL_ERROR_NULL Pool is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Workers is larger than RL_PARALLEL_MAX_WORKERS.
+ * @retval RL_ERROR_NO_MEM Thread could not be created.
+ */
+rl_status_t rl_parallel_init (rl_parallel_pool_t * const pool, const size_t workers);
+
+/**
+ * @brief Stop and join worker threads.
+ *
+ * @param[in,out] pool Pool to stop.
+ * @retval RL_SUCCESS Pool was stopped.
+ * @retval RL_ERROR_NULL Pool is NULL.
+ */
+rl_status_t rl_parallel_uninit (rl_parallel_pool_t * const pool);
+
+/**
+ * @brief Run task for workers + 1 parts and return when every part is done.
+ *
+ * Calling thread runs the last part. One job runs at a time per pool,
+ * don't call from several threads or from a task.
+ *
+ * @param[in,out] pool Started pool.
+ * @param[in]     task Task to run.
+ * @param[in]     context Passed as is to task.
+ * @retval RL_SUCCESS Every part was run.
+ * @retval RL_ERROR_NULL Pool or task is NULL.
+ */
+rl_status_t rl_parallel_run (rl_parallel_pool_t * const pool,
+                             const rl_parallel_task_fp task, void * const context);
+
+/**
+ * @brief Accumulate samples into moments using every thread of the pool.
+ *
+ * @param[in,out] pool Started pool.
+ * @param[in]     data Samples to add.
+ * @param[in]     data_length Number of samples.
+ * @param[in,out] moments Accumulator the samples are merged into.
+ * @retval RL_SUCCESS Samples were added.
+ * @retval RL_ERROR_NULL Any pointer is NULL.
+ */
+rl_status_t rl_parallel_moments (rl_parallel_pool_t * const pool,
+                                 const float * const data, const size_t data_length,
+                                 rl_moments_t * const moments);
+
+/**
+ * @brief Parallel counterpart of @ref rl_stats.
+ *
+ * @param[in,out] pool Started pool.
+ * @param[in]     data Samples.
+ * @param[in]     data_length Number of samples.
+ * @param[out]    stats Statistics of samples, every field NAN if function fails.
+ * @retval RL_SUCCESS Statistics were calculated.
+ * @retval RL_ERROR_NULL Any pointer is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Data length is zero.
+ * @retval RL_ERROR_NO_DATA Any of given values is NAN or infinite.
+ */
+rl_status_t rl_parallel_stats (rl_parallel_pool_t * const pool,
+                               const float * const data, const size_t data_length,
+                               rl_stats_t * const stats);
+
+/**
+ * @brief Parallel counterpart of @ref rl_rms.
+ *
+ * @return RMS of values, NAN if any of given values is NAN or input parameters are invalid
+ */
+float rl_parallel_rms (rl_parallel_pool_t * const pool,
+                       const float * const data, const size_t data_length);
+
+/**
+ * @brief Parallel counterpart of @ref rl_variance.
+ *
+ * @return Variance of values, NAN if any of given values is NAN or input parameters are invalid
+ */
+float rl_parallel_variance (rl_parallel_pool_t * const pool,
+                            const float * const data, const size_t data_length);
+
+/** @} */ // End of group analysis
+
+#endif
+#endif
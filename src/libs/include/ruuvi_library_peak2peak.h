@@ -6,12 +6,16 @@
  * @copyright Copyright 2019 Ruuvi Innovations.
  *   This project is released under the BSD-3-Clause License.
  *
- * Calculate the difference between lowest and highest value in given sample set.
+ * Calculate the difference between lowest and highest value in given sample set,
+ * either over an array or over a sliding window of streamed samples.
  */
 
 #ifndef RUUVI_LIBRARY_PEAK2PEAK_H
 #define RUUVI_LIBRARY_PEAK2PEAK_H
+#include "ruuvi_library.h"
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 /// @cond 0
 #ifndef NAN
@@ -34,5 +38,116 @@
  */
 float rl_peak2peak (const float * const data, const size_t data_length);
 
+/**
+ * @brief Calculate the difference between lowest and highest of every stride:th value.
+ *
+ * Stride 1 is the same as @ref rl_peak2peak.
+ *
+ * @param data[in] Pointer to first value
+ * @param data_length[in] Number of values
+ * @param stride[in] Distance between values in floats
+ * @return Difference between min and max, NAN if any of given values is NAN or input parameters are invalid
+ */
+float rl_peak2peak_strided (const float * const data, const size_t data_length,
+                            const size_t stride);
+
+/**
+ * @brief Sample which may become minimum or maximum of a sliding window.
+ */
+typedef struct
+{
+    float value;       //!< Value of sample.
+    uint32_t sequence; //!< Running number of sample, used to find when it leaves the window.
+} rl_peak2peak_extremum_t;
+
+/**
+ * @brief Monotonic deque of extremum candidates, circular over window length elements.
+ */
+typedef struct
+{
+    rl_peak2peak_extremum_t * const items; //!< Storage for window length candidates.
+    size_t first;                          //!< Index of oldest candidate.
+    size_t count;                          //!< Number of candidates.
+} rl_peak2peak_deque_t;
+
+/**
+ * @brief Peak to peak of the last length samples, updated in O(1) amortized per sample.
+ *
+ * Keeps an increasing deque of minimum candidates and a decreasing deque of
+ * maximum candidates. A new sample drops the candidates it beats, and the oldest
+ * candidate is dropped once it leaves the window, so each sample enters and
+ * leaves a deque at most once. Samples themselves are not stored, deques need
+ * at most length candidates each in caller-provided storage.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static rl_peak2peak_extremum_t mins[200];
+ * static rl_peak2peak_extremum_t maxs[200];
+ * static rl_peak2peak_window_t window = {.length = 200,
+ *                                        .min = {.items = mins},
+ *                                        .max = {.items = maxs}};
+ * rl_peak2peak_window_init(&window);
+ * \endcode
+ */
+typedef struct
+{
+    const size_t length;      //!< Number of samples in a full window.
+    rl_peak2peak_deque_t min; //!< Increasing candidates for minimum.
+    rl_peak2peak_deque_t max; //!< Decreasing candidates for maximum.
+    size_t count;             //!< Number of samples in window.
+    size_t finite_run;        //!< Consecutive finite samples at end, saturates at length.
+    uint32_t sequence;        //!< Running number of next sample.
+} rl_peak2peak_window_t;
+
+/**
+ * @brief Empty the window.
+ *
+ * @param[in,out] window Window to initialize.
+ * @retval RL_SUCCESS Window was initialized.
+ * @retval RL_ERROR_NULL Window or deque storage is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Length is zero or doesn't fit sequence numbers.
+ */
+rl_status_t rl_peak2peak_window_init (rl_peak2peak_window_t * const window);
+
+/**
+ * @brief Add sample to window, the oldest sample leaves once window is full.
+ *
+ * @param[in,out] window Window to update.
+ * @param[in]     sample New sample, NAN and infinity make peak to peak NAN until
+ *                       they leave the window.
+ * @retval RL_SUCCESS Sample was added.
+ * @retval RL_ERROR_NULL Window is NULL.
+ */
+rl_status_t rl_peak2peak_window_push (rl_peak2peak_window_t * const window,
+                                      const float sample);
+
+/**
+ * @brief Difference between min and max in window, same as @ref rl_peak2peak over it.
+ *
+ * @param[in] window Window to read.
+ * @return Peak to peak, NAN if window is NULL, empty or has non-finite samples.
+ */
+float rl_peak2peak_window_value (const rl_peak2peak_window_t * const window);
+
+/**
+ * @brief Calculate the difference between lowest and highest raw int16 count.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values
+ * @return Difference between min and max, NAN if input parameters are invalid
+ */
+float rl_peak2peak_i16 (const int16_t * const data, const size_t data_length);
+
+/**
+ * @brief Calculate the difference between lowest and highest raw int32 count.
+ *
+ * Difference is calculated in int64 and rounded to float once.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values
+ * @return Difference between min and max, NAN if input parameters are invalid
+ */
+float rl_peak2peak_i32 (const int32_t * const data, const size_t data_length);
+
 /** @} */ // End of group analysis
 #endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**
+ * @file ruuvi_library_quantile.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Streaming quantile estimator in fixed memory, with merge.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Estimate median, P95 and other quantiles of a stream without storing or sorting
+ * the samples. State is a merging t-digest: samples are summarized by centroids,
+ * a mean and a count, which are small near the ends of the distribution and large
+ * in the middle. Tail quantiles are therefore more accurate than the median in
+ * absolute rank, and min and max are exact.
+ *
+ * Memory is fixed at compile time, 8 bytes per centroid and buffered sample plus
+ * a few counters, about 1 kB with defaults. No heap is used.
+ *
+ * New samples are appended to a buffer. When the buffer is full, centroids and
+ * buffer are sorted together and compressed back to at most RL_QUANTILE_CENTROIDS
+ * centroids. A push costs O(1), plus amortized
+ * O((RL_QUANTILE_CENTROIDS + RL_QUANTILE_BUFFER) * log(RL_QUANTILE_CENTROIDS +
+ * RL_QUANTILE_BUFFER) / RL_QUANTILE_BUFFER) comparisons for the compression.
+ *
+ * As long as at most RL_QUANTILE_CENTROIDS samples have been pushed, quantiles are
+ * exact. Afterwards rank error is typically below 0.5 %, and below 0.2 % at P1 and
+ * P99 with default sizes.
+ *
+ * Digests of different windows, threads or sensors can be merged, the result
+ * estimates quantiles of all samples together.
+ */
+
+#ifndef RUUVI_LIBRARY_QUANTILE_H
+#define RUUVI_LIBRARY_QUANTILE_H
+#include "ruuvi_library.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+/// @cond 0
+#ifndef NAN
+#   error "NAN is not defined"
+#endif
+/// @endcond
+
+/** @ingroup analysis
+ *  @{
+ */
+
+#ifndef RL_QUANTILE_CENTROIDS
+/** @brief Maximum number of centroids after compression, sets accuracy. */
+#   define RL_QUANTILE_CENTROIDS (64U)
+#endif
+
+#ifndef RL_QUANTILE_BUFFER
+/** @brief Samples buffered before compression, larger is faster. */
+#   define RL_QUANTILE_BUFFER (64U)
+#endif
+
+/**
+ * @brief Summary of samples close to each other.
+ */
+typedef struct
+{
+    float mean;     //!< Mean of samples in centroid.
+    uint32_t count; //!< Number of samples in centroid.
+} rl_quantile_centroid_t;
+
+/**
+ * @brief State of quantile estimator, initialize with @ref rl_quantile_init.
+ */
+typedef struct
+{
+    //!< Compressed centroids sorted by mean, followed by unsorted buffered centroids.
+    rl_quantile_centroid_t centroids[RL_QUANTILE_CENTROIDS + RL_QUANTILE_BUFFER];
+    size_t compressed;  //!< Number of compressed centroids.
+    size_t buffered;    //!< Number of buffered centroids after compressed ones.
+    uint64_t count;     //!< Number of samples.
+    float min;          //!< Smallest sample.
+    float max;          //!< Largest sample.
+    bool finite;        //!< False once a NAN or infinite sample has been added.
+} rl_quantile_t;
+
+/**
+ * @brief Reset estimator to empty state.
+ *
+ * @param[out] quantile Estimator to reset.
+ * @retval RL_SUCCESS Estimator was reset.
+ * @retval RL_ERROR_NULL Estimator is NULL.
+ */
+rl_status_t rl_quantile_init (rl_quantile_t * const quantile);
+
+/**
+ * @brief Add one sample.
+ *
+ * A NAN or infinite sample makes every quantile NAN, like with @ref rl_rms.
+ *
+ * @param[in,out] quantile Estimator to update.
+ * @param[in]     value Sample to add.
+ * @retval RL_SUCCESS Sample was added.
+ * @retval RL_ERROR_NULL Estimator is NULL.
+ */
+rl_status_t rl_quantile_push (rl_quantile_t * const quantile, const float value);
+
+/**
+ * @brief Add samples of an array.
+ *
+ * @param[in,out] quantile Estimator to update.
+ * @param[in]     data Samples to add.
+ * @param[in]     data_length Number of samples.
+ * @retval RL_SUCCESS Samples were added.
+ * @retval RL_ERROR_NULL Estimator or data is NULL.
+ */
+rl_status_t rl_quantile_push_n (rl_quantile_t * const quantile,
+                                const float * const data, const size_t data_length);
+
+/**
+ * @brief Add every sample summarized by other estimator.
+ *
+ * Other may be the same estimator, which counts every sample twice.
+ *
+ * @param[in,out] quantile Estimator to update.
+ * @param[in]     other Estimator to add, not modified.
+ * @retval RL_SUCCESS Estimators were merged.
+ * @retval RL_ERROR_NULL Either estimator is NULL.
+ */
+rl_status_t rl_quantile_merge (rl_quantile_t * const quantile,
+                               const rl_quantile_t * const other);
+
+/**
+ * @brief Estimate quantile of samples.
+ *
+ * Quantiles interpolate linearly between sample ranks k - 0.5, so median of an even
+ * number of samples is the mean of the two middle samples. Buffered samples are
+ * compressed first, hence the estimator is not const.
+ *
+ * @param[in,out] quantile Estimator to read.
+ * @param[in]     q Quantile to estimate, 0.5 for median, 0.95 for P95.
+ * @return Estimated quantile, NAN if estimator is NULL or empty, it has non-finite
+ *         samples, or q is not within 0 ... 1.
+ */
+float rl_quantile_value (rl_quantile_t * const quantile, const float q);
+
+/** @} */ // End of group analysis
+#endif
@@ -11,6 +11,11 @@
  * - no locking between read / write, and thread-safe reads/writes.
  * The tradeoffs are that the data storage must have size of power of two and
  * the elemements are treated in chunks with size of power of two.
+ *
+ * If there is exactly one producer and one consumer, for example a sensor interrupt
+ * and the main loop, the lock function can be left NULL. The buffer then runs in
+ * lock-free single-producer, single-consumer mode where head and tail are published
+ * with C11 acquire/release atomics.
  */
 /*@{*/
 
@@ -18,6 +23,8 @@
 #define  RUUVI_LIBRARY_RINGBUFFER_H
 
 #include "ruuvi_library.h"
+#include "ruuvi_library_enabled_modules.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -47,6 +54,116 @@
 typedef bool (*rl_atomic_flag) (volatile uint32_t * const flag,
                                 const bool set);
 
+#ifndef RL_RINGBUFFER_CACHE_LINE_SIZE
+/**
+ * @brief Size of CPU cache line in bytes.
+ *
+ * Non-zero value places producer-owned and consumer-owned state of
+ * @ref rl_ringbuffer_t on separate cache lines, so that on a multicore host a
+ * producer write doesn't invalidate the consumer's line and vice versa.
+ * Leave at 0 on single-core MCUs, for example 64 on x86 and most ARM application cores.
+ * Must be same for every translation unit of application. Buffers allocated with
+ * malloc are not guaranteed to honor alignment larger than max_align_t.
+ */
+#   define RL_RINGBUFFER_CACHE_LINE_SIZE (0U)
+#endif
+
+/// @cond 0
+#if RL_RINGBUFFER_CACHE_LINE_SIZE
+#   define RL_RINGBUFFER_CACHE_ALIGNED _Alignas (RL_RINGBUFFER_CACHE_LINE_SIZE)
+#else
+#   define RL_RINGBUFFER_CACHE_ALIGNED
+#endif
+/// @endcond
+
+/**
+ * @brief Put calling thread to sleep while word holds expected value.
+ *
+ * Futex-style wait used by @ref rl_ringbuffer_wait. Implementation must not sleep
+ * if word no longer equals expected, otherwise a wakeup between the check in the
+ * ringbuffer and the sleep is lost. On Linux this maps directly to FUTEX_WAIT,
+ * a condition variable implementation compares word while holding its mutex.
+ * Spurious wakeups are allowed.
+ *
+ * @param[in] context    Context of @ref rl_ringbuffer_waiter_t.
+ * @param[in] word       Wake sequence of ringbuffer.
+ * @param[in] expected   Value of word read before deciding to sleep.
+ * @param[in] timeout_ms Maximum time to sleep in milliseconds.
+ * @retval    RL_SUCCESS Woken up or word changed.
+ * @retval    RL_ERROR_NO_DATA Timeout expired.
+ */
+typedef rl_status_t (*rl_ringbuffer_wait_fp) (void * const context,
+        _Atomic uint32_t * const word,
+        const uint32_t expected,
+        const uint32_t timeout_ms);
+
+/**
+ * @brief Wake all threads sleeping on word, for example FUTEX_WAKE.
+ *
+ * Called by producer after publishing data, must not block.
+ *
+ * @param[in] context Context of @ref rl_ringbuffer_waiter_t.
+ * @param[in] word    Wake sequence of ringbuffer.
+ */
+typedef void (*rl_ringbuffer_notify_fp) (void * const context,
+        _Atomic uint32_t * const word);
+
+/**
+ * @brief Read monotonic millisecond clock, may wrap around.
+ *
+ * Used by @ref rl_ringbuffer_wait to sleep only for the remaining timeout after
+ * a wakeup which didn't bring enough data.
+ *
+ * @param[in] context Context of @ref rl_ringbuffer_waiter_t.
+ * @return Current time in milliseconds.
+ */
+typedef uint32_t (*rl_ringbuffer_now_fp) (void * const context);
+
+/**
+ * @brief Platform hooks for blocking consumers.
+ */
+typedef struct
+{
+    const rl_ringbuffer_wait_fp wait;     //!< Sleep until notified or timeout.
+    const rl_ringbuffer_notify_fp notify; //!< Wake sleeping consumers.
+    const rl_ringbuffer_now_fp now_ms;    //!< Read clock for timeouts.
+    void * const context;                 //!< Passed as is to wait and notify.
+} rl_ringbuffer_waiter_t;
+
+/**
+ * @brief Contiguous run of elements in ringbuffer storage.
+ */
+typedef struct
+{
+    const void * data; //!< First element of span, NULL if span is empty.
+    size_t count;      //!< Number of elements in span.
+} rl_ringbuffer_span_t;
+
+/**
+ * @brief Snapshot of ringbuffer statistics, see @ref rl_ringbuffer_stats_get.
+ *
+ * Counters are element counts which wrap around at SIZE_MAX, compare two snapshots
+ * to get throughput over an interval.
+ */
+typedef struct
+{
+    size_t queued;        //!< Elements queued.
+    size_t dequeued;      //!< Elements dequeued.
+    size_t peak;          //!< Highest number of stored elements after a queue.
+    size_t rejected;      //!< Elements rejected with RL_ERROR_NO_MEM.
+    size_t dropped;       //!< Elements dropped by overwrite policy.
+    size_t lock_failures; //!< Lock attempts which failed with RL_ERROR_CONCURRENCY.
+} rl_ringbuffer_stats_t;
+
+/**
+ * @brief Behaviour of a full ringbuffer on queue.
+ */
+typedef enum
+{
+    RL_RINGBUFFER_POLICY_REJECT = 0, //!< Reject new element with RL_ERROR_NO_MEM, default.
+    RL_RINGBUFFER_POLICY_OVERWRITE   //!< Drop oldest element to make room for new one.
+} rl_ringbuffer_policy_t;
+
 /* @brief Struct definition for ringbuffer.
  *
  * Initialization example:
@@ -64,21 +181,67 @@ typedef bool (*rl_atomic_flag) (volatile uint32_t * const flag,
  *                                              .writelock = &buffer_wlock;
  *                                              .readlock  = &buffer_rlock};
  * \endcode
+ *
+ * Lock-free single-producer, single-consumer buffer:
+ * \code{.c}
+ * static rl_ringbuffer_t spsc_ringbuf = {.head = 0,
+ *                                        .tail = 0,
+ *                                        .block_size = 32,
+ *                                        .storage_size = sizeof(buffer_data),
+ *                                        .index_mask = (sizeof(buffer_data) / 32) - 1,
+ *                                        .storage = buffer_data,
+ *                                        .lock = NULL,
+ *                                        .writelock = NULL,
+ *                                        .readlock  = NULL};
+ * \endcode
  */
 typedef struct
 {
-    size_t head;               //!< Ringbuffer head index
-    size_t tail;               //!< Ringbuffer tail index
+    // Producer-owned state.
+    RL_RINGBUFFER_CACHE_ALIGNED
+    _Atomic size_t head;       //!< Count of elements queued, masked to index storage.
+    size_t tail_cache;         //!< Producer's copy of tail, reloaded when buffer seems full.
+    _Atomic size_t dropped;    //!< Number of elements dropped by overwrite.
+    _Atomic uint32_t wake_seq; //!< Incremented by producer before waking consumers.
+#if RL_RINGBUFFER_STATS_ENABLED
+    _Atomic size_t stat_queued;    //!< Elements queued.
+    _Atomic size_t stat_peak;      //!< Highest number of stored elements after a queue.
+    _Atomic size_t stat_rejected;  //!< Elements rejected as buffer was full.
+    _Atomic size_t stat_lock_failures; //!< Failed lock attempts, any lock.
+#endif
+    // Consumer-owned state.
+    RL_RINGBUFFER_CACHE_ALIGNED
+    _Atomic size_t tail;       //!< Count of elements dequeued or dropped, masked to index.
+    size_t head_cache;         //!< Consumer's copy of head, reloaded when buffer seems empty.
+    _Atomic size_t wake_threshold; //!< Smallest count of sleeping consumers, 0 if none.
+#if RL_RINGBUFFER_STATS_ENABLED
+    _Atomic size_t stat_dequeued;  //!< Elements dequeued.
+#endif
+    // Constant configuration, only read after initialization.
+    RL_RINGBUFFER_CACHE_ALIGNED
     const size_t block_size;   //!< Block size of elements, must be power of two
     const size_t storage_size; //!< Size of storage element, must be power of two.
     const size_t index_mask;   //!< Bitmask of indexes. Must be (storege_size / block_size) -1
     void * const storage;      //!< Pointer to storage.
     /** @brief Function pointer to lock ringbuffer. Can be a dummy implementation which only
      *         returns true if buffer is used in single-thread environment without interrupts.
+     *         NULL selects lock-free single-producer, single-consumer mode.
      */
     const rl_atomic_flag lock;
     volatile void * const writelock;    //!< Memory address for flag locking write function
     volatile void * const readlock;     //!< Memory address for flag locking read function.
+    /** @brief Behaviour when full. With RL_RINGBUFFER_POLICY_OVERWRITE producer moves
+     *         tail past the oldest element before publishing the new one. In locked
+     *         mode producer takes the read lock for this, in lock-free mode consumer
+     *         and producer advance tail with compare-and-swap. Tail is a free-running
+     *         counter, so the compare fails even if producer dropped exactly a buffer's
+     *         worth of elements while consumer was reading.
+     */
+    const rl_ringbuffer_policy_t policy;
+    /** @brief Hooks for @ref rl_ringbuffer_wait. NULL if consumers never block,
+     *         producer then skips the wakeup check entirely.
+     */
+    const rl_ringbuffer_waiter_t * const waiter;
 } rl_ringbuffer_t;
 
 /**
@@ -91,8 +254,9 @@ typedef struct
  * @param[in] data Data to store
  * @param[in] data_length length of data, at most @ref block_size.
  * @retval    RL_SUCCESS Data was queued.
- * @retval    RL_ERROR_NO_MEM The ringbuffer was full.
- * @retval    RL_ERROR_CONCURRENCY Could not obtain lock.
+ * @retval    RL_ERROR_NO_MEM The ringbuffer was full and policy rejects new elements.
+ * @retval    RL_ERROR_CONCURRENCY Could not obtain lock, or read lock to drop oldest element
+ *                                 in overwrite mode. Never returned in lock-free mode.
  * @retval    RL_ERROR_FATAL Lock could not be released.
  * @retval    RL_ERROR_NULL  Data or buffer are NULL.
  * @retval    RL_ERROR_DATA_LENGTH Data is bigger than buffer block size.
@@ -101,6 +265,48 @@ rl_status_t rl_ringbuffer_queue (rl_ringbuffer_t * const buffer,
                                  const void * const data,
                                  const size_t data_length);
 
+/**
+ * @brief Reserve next free slot of ringbuffer for writing in place.
+ *
+ * Returns pointer to the slot at head of the buffer so that producer can write
+ * element directly into storage without an intermediate copy. The element becomes
+ * visible to consumer only after @ref rl_ringbuffer_commit. Write lock is held
+ * from successful reservation until commit, other producers get
+ * RL_ERROR_CONCURRENCY meanwhile.
+ *
+ * \code{.c}
+ * rl_data_t * p_sample;
+ * if(RL_SUCCESS == rl_ringbuffer_reserve(&ringbuf, &p_sample))
+ * {
+ *     decode_sample(p_sample);
+ *     rl_ringbuffer_commit(&ringbuf);
+ * }
+ * \endcode
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to reserve slot from.
+ * @param[out]    data Pointer to data, will be assigned at the start of the free slot.
+ *                     Slot has room for @ref block_size bytes.
+ * @retval    RL_SUCCESS Slot was reserved, must be followed by exactly one commit.
+ * @retval    RL_ERROR_NO_MEM The ringbuffer was full and policy rejects new elements.
+ * @retval    RL_ERROR_CONCURRENCY Could not obtain lock, or read lock to drop oldest element
+ *                                 in overwrite mode. Never returned in lock-free mode.
+ * @retval    RL_ERROR_FATAL Lock could not be released after failed reservation.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ */
+rl_status_t rl_ringbuffer_reserve (rl_ringbuffer_t * const buffer,
+                                   void * const data);
+
+/**
+ * @brief Publish slot reserved with @ref rl_ringbuffer_reserve.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer which has a reserved slot.
+ * @retval    RL_SUCCESS Element was published.
+ * @retval    RL_ERROR_FATAL Lock could not be released.
+ * @retval    RL_ERROR_NULL  Buffer is NULL.
+ * @warning   Calling this function without a successful reservation corrupts the buffer.
+ */
+rl_status_t rl_ringbuffer_commit (rl_ringbuffer_t * const buffer);
+
 /**
  * @brief Dequeue data from ringbuffer
  *
@@ -115,11 +321,106 @@ rl_status_t rl_ringbuffer_queue (rl_ringbuffer_t * const buffer,
  * @retval        RL_SUCCESS Data was dequeued.
  * @retval        RL_ERROR_NULL Any input pointer is NULL.
  * @retval        RL_ERROR_NO_DATA The ringbuffer was empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
  * @warning       Data returned by this function can be overwritten, take a deep copy if required.
+ *                In overwrite mode use @ref rl_ringbuffer_dequeue_n, which copies the data
+ *                and retries if producer dropped the elements during copy.
  */
 rl_status_t rl_ringbuffer_dequeue (rl_ringbuffer_t * const buffer,
                                    void * const data);
 
+/**
+ * @brief Queue several elements into ringbuffer under one lock.
+ *
+ * Copies count elements of @ref block_size bytes each. The copy is split into at
+ * most two memcpy calls around the end of storage. Either all elements are queued
+ * or none are.
+ *
+ * @param[in] buffer Pointer to ringbuffer to store data into
+ * @param[in] data Elements to store, count * block_size bytes.
+ * @param[in] count Number of elements to store.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_NO_MEM The ringbuffer doesn't have room for count elements and
+ *                            policy rejects new elements.
+ * @retval    RL_ERROR_CONCURRENCY Could not obtain lock, or read lock to drop oldest elements
+ *                                 in overwrite mode. Never returned in lock-free mode.
+ * @retval    RL_ERROR_FATAL Lock could not be released.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ * @retval    RL_ERROR_DATA_LENGTH Count is larger than capacity of the buffer.
+ */
+rl_status_t rl_ringbuffer_queue_n (rl_ringbuffer_t * const buffer,
+                                   const void * const data,
+                                   const size_t count);
+
+/**
+ * @brief Dequeue several elements from ringbuffer under one lock.
+ *
+ * Copies up to count elements of @ref block_size bytes each out of the buffer.
+ * Unlike @ref rl_ringbuffer_dequeue the data is copied, as a range of elements may
+ * wrap around the end of storage.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to load data from
+ * @param[out]    data Buffer for elements, at least count * block_size bytes.
+ * @param[in,out] count In: Maximum number of elements to dequeue.
+ *                      Out: Number of elements dequeued.
+ * @retval        RL_SUCCESS Data was dequeued.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_NO_DATA The ringbuffer was empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ */
+rl_status_t rl_ringbuffer_dequeue_n (rl_ringbuffer_t * const buffer,
+                                     void * const data,
+                                     size_t * const count);
+
+/**
+ * @brief Sleep until ringbuffer has at least count elements.
+ *
+ * Consumer sleeps in @ref rl_ringbuffer_waiter_t wait hook instead of polling
+ * @ref rl_ringbuffer_empty. Producer wakes it from queue and commit once count
+ * elements are stored, so a batch of count elements costs one wakeup.
+ * Concurrent waiters may use different counts: producer wakes every consumer once
+ * the smallest count is reached, and the others go back to sleep with their own
+ * count. Timeout covers the whole call, after a spurious wakeup wait hook gets the
+ * remaining time.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to wait on.
+ * @param[in]     count Number of elements to wait for, 1 to wake on any data.
+ * @param[in]     timeout_ms Maximum time to sleep.
+ * @retval        RL_SUCCESS At least count elements are stored.
+ * @retval        RL_ERROR_NULL Buffer is NULL, it has no waiter or waiter has no clock.
+ * @retval        RL_ERROR_DATA_LENGTH Count is 0 or larger than capacity of the buffer.
+ * @retval        RL_ERROR_NO_DATA Timeout expired before count elements were stored.
+ */
+rl_status_t rl_ringbuffer_wait (rl_ringbuffer_t * const buffer,
+                                const size_t count,
+                                const uint32_t timeout_ms);
+
+/**
+ * @brief Dequeue a batch of elements, sleeping until the batch is ready.
+ *
+ * Waits with @ref rl_ringbuffer_wait until count elements are stored and then
+ * dequeues them with @ref rl_ringbuffer_dequeue_n. If timeout expires, elements
+ * stored so far are returned as a partial batch.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to load data from
+ * @param[out]    data Buffer for elements, at least count * block_size bytes.
+ * @param[in,out] count In: Number of elements to wait for and dequeue at most.
+ *                      Out: Number of elements dequeued.
+ * @param[in]     timeout_ms Maximum time to sleep, passed to wait hook.
+ * @retval        RL_SUCCESS Data was dequeued, possibly fewer than count after timeout.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL or buffer has no waiter.
+ * @retval        RL_ERROR_DATA_LENGTH Count is 0.
+ * @retval        RL_ERROR_NO_DATA Timeout expired with the ringbuffer empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ */
+rl_status_t rl_ringbuffer_dequeue_wait (rl_ringbuffer_t * const buffer,
+                                        void * const data,
+                                        size_t * const count,
+                                        const uint32_t timeout_ms);
+
 /**
  * @brief Peek data in ringbuffer
  *
@@ -135,10 +436,127 @@ rl_status_t rl_ringbuffer_dequeue (rl_ringbuffer_t * const buffer,
  * @retval        RL_ERROR_NULL Any input pointer is NULL.
  * @retval        RL_ERROR_NO_DATA The ringbuffer doesn't have element at the given index.
  * @warning       Data returned by this function can be overwritten, take a deep copy if required.
+ *                Only consumer should peek in lock-free mode, and not at all in lock-free
+ *                overwrite mode.
  */
 rl_status_t rl_ringbuffer_peek (rl_ringbuffer_t * const buffer,
                                 const void * data, const size_t index);
 
+/**
+ * @brief Peek a range of elements in ringbuffer as at most two contiguous spans.
+ *
+ * Covers count elements starting from tail + index. The range is split in two only
+ * if it wraps around the end of storage, second span is empty otherwise. This lets
+ * analysis functions run directly over storage without peeking element by element
+ * or copying into a flat array:
+ * \code{.c}
+ * rl_ringbuffer_span_t spans[2];
+ * const size_t stored = rl_ringbuffer_count(&ringbuf);
+ * if(RL_SUCCESS == rl_ringbuffer_peek_range(&ringbuf, stored - 256, 256, spans))
+ * {
+ *     process(spans[0].data, spans[0].count);
+ *     process(spans[1].data, spans[1].count);
+ * }
+ * \endcode
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to peek data from
+ * @param[in]     index Offset of first element, starting from tail.
+ * @param[in]     count Number of elements in range.
+ * @param[out]    spans Two spans covering the range in order.
+ * @retval        RL_SUCCESS Spans were assigned.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_NO_DATA The ringbuffer doesn't have all elements of the range.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ * @warning       Spans point into storage and can be overwritten after function returns,
+ *                as with @ref rl_ringbuffer_peek. Only consumer should peek in
+ *                lock-free mode, and not at all in lock-free overwrite mode.
+ */
+rl_status_t rl_ringbuffer_peek_range (rl_ringbuffer_t * const buffer,
+                                      const size_t index, const size_t count,
+                                      rl_ringbuffer_span_t spans[2]);
+
+/**
+ * @brief Find first element with timestamp at or after given time.
+ *
+ * Elements must start with a uint32_t timestamp, as rl_data_t does, and be queued
+ * in non-decreasing time order. Binary search over logical indices from tail takes
+ * O(log n) peeks instead of a linear scan. Timestamps are compared relative to the
+ * oldest element, so a wrap of the 32-bit timestamp counter is handled as long as
+ * the buffer spans less than 2^31 ticks.
+ *
+ * \code{.c}
+ * size_t index;
+ * rl_ringbuffer_span_t spans[2];
+ * if(RL_SUCCESS == rl_ringbuffer_find_time(&ringbuf, since, &index))
+ * {
+ *     rl_ringbuffer_peek_range(&ringbuf, index, rl_ringbuffer_count(&ringbuf) - index, spans);
+ * }
+ * \endcode
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to search.
+ * @param[in]     time Timestamp to search for.
+ * @param[out]    index Offset from tail of first element at or after time, number of
+ *                      stored elements if there is no such element.
+ * @retval        RL_SUCCESS Element was found.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_DATA_LENGTH Block size is smaller than a timestamp.
+ * @retval        RL_ERROR_NO_DATA All elements are older than time or buffer is empty.
+ * @retval        RL_ERROR_CONCURRENCY Could not obtain lock. Never returned in lock-free mode.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ * @warning       Timestamps are read from storage while producer may overwrite them,
+ *                as with @ref rl_ringbuffer_peek. Only consumer should search in
+ *                lock-free mode, and not at all in lock-free overwrite mode.
+ */
+rl_status_t rl_ringbuffer_find_time (rl_ringbuffer_t * const buffer,
+                                     const uint32_t time,
+                                     size_t * const index);
+
+/**
+ * @brief Empty the ringbuffer.
+ *
+ * Resets head, tail, their cached copies and statistics. Use this
+ * instead of assigning head and tail directly. Must not be called while buffer is in use.
+ *
+ * @param[in,out] buffer Ringbuffer to reset. NULL is ignored.
+ */
+void rl_ringbuffer_reset (rl_ringbuffer_t * const buffer);
+
+#if RL_RINGBUFFER_STATS_ENABLED || DOXYGEN
+/**
+ * @brief Take a snapshot of ringbuffer statistics.
+ *
+ * Available if RL_RINGBUFFER_STATS_ENABLED is set to 1 in application configuration.
+ * Statistics are then updated on every queue and dequeue by the owner of the
+ * counter with relaxed atomics. With the option off the counters and their updates
+ * are compiled out.
+ * Counters are read one by one, a snapshot taken while buffer is in use may mix
+ * values from before and after a concurrent operation.
+ *
+ * @param[in]  buffer Ringbuffer to read statistics of.
+ * @param[out] stats Snapshot of statistics.
+ * @retval     RL_SUCCESS Snapshot was taken.
+ * @retval     RL_ERROR_NULL Any input pointer is NULL.
+ */
+rl_status_t rl_ringbuffer_stats_get (const rl_ringbuffer_t * const buffer,
+                                     rl_ringbuffer_stats_t * const stats);
+
+/**
+ * @brief Zero ringbuffer statistics, including dropped element counter.
+ *
+ * Peak starts again from current occupancy on next queue. Call while buffer is idle,
+ * an update running concurrently with reset may restore the old value of its counter.
+ *
+ * @param[in,out] buffer Ringbuffer to reset statistics of. NULL is ignored.
+ */
+void rl_ringbuffer_stats_reset (rl_ringbuffer_t * const buffer);
+#endif
+
+/*
+ * return number of elements in ringbuffer
+ */
+size_t rl_ringbuffer_count (const rl_ringbuffer_t * const buffer);
+
 /*
  * return true if rinbuffer is full
  */
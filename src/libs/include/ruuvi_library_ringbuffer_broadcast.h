@@ -0,0 +1,162 @@
+/**
+ * @file ruuvi_library_ringbuffer_broadcast.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Single-producer ringbuffer read by several independent consumers.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Companion of @ref rl_ringbuffer_t for streams which are consumed by several
+ * readers, for example live statistics, compression to flash and BLE forwarding.
+ * Every element is stored once. Each reader has its own cursor and reads elements
+ * in place, a slot is reused only after the slowest attached reader has released it.
+ *
+ * Head and cursors are element counters modulo twice the number of slots, published
+ * with C11 acquire/release atomics, so the buffer is lock-free for one producer and
+ * one thread per reader cursor. All index_mask + 1 slots are usable.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_RINGBUFFER_BROADCAST_H
+#define  RUUVI_LIBRARY_RINGBUFFER_BROADCAST_H
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Cursor value of a reader which doesn't hold back the producer. */
+#define RL_RINGBUFFER_BROADCAST_DETACHED (SIZE_MAX)
+
+/* @brief Struct definition for broadcast ringbuffer.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static uint8_t buffer_data[1024];
+ * static _Atomic size_t buffer_cursors[3];
+ * static rl_ringbuffer_broadcast_t ringbuf = {.head = 0,
+ *                                             .block_size = 32,
+ *                                             .storage_size = sizeof(buffer_data),
+ *                                             .index_mask = (sizeof(buffer_data) / 32) - 1,
+ *                                             .storage = buffer_data,
+ *                                             .cursors = buffer_cursors,
+ *                                             .reader_count = 3};
+ * rl_ringbuffer_broadcast_init(&ringbuf);
+ * \endcode
+ */
+typedef struct
+{
+    _Atomic size_t head;             //!< Count of elements published by producer.
+    size_t tail_cache;               //!< Producer's copy of slowest reader cursor.
+    const size_t block_size;         //!< Block size of elements.
+    const size_t storage_size;       //!< Size of storage element, must be power of two.
+    const size_t index_mask;         //!< Bitmask of indexes. Must be (storage_size / block_size) -1
+    void * const storage;            //!< Pointer to storage.
+    _Atomic size_t * const cursors;  //!< Count of elements released per reader.
+    const size_t reader_count;       //!< Number of elements in cursors.
+} rl_ringbuffer_broadcast_t;
+
+/**
+ * @brief Reset ringbuffer to empty state with every reader attached.
+ *
+ * Must be called before first use and must not be called while other threads use
+ * the buffer.
+ *
+ * @param[in,out] buffer Ringbuffer to initialize.
+ * @retval RL_SUCCESS Buffer was initialized.
+ * @retval RL_ERROR_NULL Buffer, its storage or its cursor array is NULL.
+ */
+rl_status_t rl_ringbuffer_broadcast_init (rl_ringbuffer_broadcast_t * const buffer);
+
+/**
+ * @brief Queue data into ringbuffer
+ *
+ * This function operates on the head of the buffer, and rejects operation if
+ * the slowest attached reader has not released the slot. Only one thread may queue.
+ *
+ * @param[in] buffer Pointer to ringbuffer to store data into
+ * @param[in] data Data to store
+ * @param[in] data_length length of data, at most @ref block_size.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_NO_MEM The ringbuffer was full for the slowest reader.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ * @retval    RL_ERROR_DATA_LENGTH Data is bigger than buffer block size.
+ */
+rl_status_t rl_ringbuffer_broadcast_queue (rl_ringbuffer_broadcast_t * const buffer,
+        const void * const data,
+        const size_t data_length);
+
+/**
+ * @brief View all elements not yet released by a reader.
+ *
+ * Elements are returned in place as at most two contiguous spans, see
+ * @ref rl_ringbuffer_peek_range. They stay valid until the reader releases them.
+ *
+ * @param[in]  buffer Pointer to ringbuffer to read.
+ * @param[in]  reader Index of reader cursor.
+ * @param[out] spans Two spans covering unread elements in order.
+ * @retval     RL_SUCCESS Spans were assigned.
+ * @retval     RL_ERROR_NULL Any input pointer is NULL.
+ * @retval     RL_ERROR_DATA_LENGTH Reader index is out of range.
+ * @retval     RL_ERROR_NO_DATA Reader has no unread elements or is detached.
+ */
+rl_status_t rl_ringbuffer_broadcast_peek (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader,
+        rl_ringbuffer_span_t spans[2]);
+
+/**
+ * @brief Mark elements as read, producer may reuse them once every reader is done.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to read.
+ * @param[in]     reader Index of reader cursor.
+ * @param[in]     count Number of oldest unread elements to release.
+ * @retval        RL_SUCCESS Elements were released.
+ * @retval        RL_ERROR_NULL Buffer is NULL.
+ * @retval        RL_ERROR_DATA_LENGTH Reader index is out of range or count is larger
+ *                                     than number of unread elements.
+ * @retval        RL_ERROR_NO_DATA Reader is detached.
+ */
+rl_status_t rl_ringbuffer_broadcast_release (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader,
+        const size_t count);
+
+/**
+ * @brief Start reading at the current head.
+ *
+ * Reader sees only elements queued after attaching. Safe to call while producer
+ * is queueing.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to read.
+ * @param[in]     reader Index of reader cursor.
+ * @retval        RL_SUCCESS Reader was attached.
+ * @retval        RL_ERROR_NULL Buffer is NULL.
+ * @retval        RL_ERROR_DATA_LENGTH Reader index is out of range.
+ */
+rl_status_t rl_ringbuffer_broadcast_attach (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader);
+
+/**
+ * @brief Stop reading, producer no longer waits for this reader.
+ *
+ * Unread elements of the reader become free for the producer.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to read.
+ * @param[in]     reader Index of reader cursor.
+ * @retval        RL_SUCCESS Reader was detached.
+ * @retval        RL_ERROR_NULL Buffer is NULL.
+ * @retval        RL_ERROR_DATA_LENGTH Reader index is out of range.
+ */
+rl_status_t rl_ringbuffer_broadcast_detach (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader);
+
+/*
+ * return number of elements not yet released by reader, 0 for detached or invalid reader.
+ */
+size_t rl_ringbuffer_broadcast_count (const rl_ringbuffer_broadcast_t * const buffer,
+                                      const size_t reader);
+
+/*@}*/
+
+#endif
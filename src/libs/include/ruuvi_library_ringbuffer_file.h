@@ -0,0 +1,117 @@
+/**
+ * @file ruuvi_library_ringbuffer_file.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Ringbuffer persisted in a memory-mapped file.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Places an @ref rl_ringbuffer_t, its head and tail and its storage in a file
+ * mapped with mmap, so that queued elements survive a restart of the process
+ * without any serialization. The mapped buffer is used with the regular
+ * rl_ringbuffer_* functions.
+ *
+ * Producer writes element before publishing head with release ordering, and consumer
+ * reads element before publishing tail, so the file is consistent at every store:
+ * if the process crashes, a reopened buffer contains exactly the committed elements.
+ * A slot reserved but not committed is discarded. Surviving a power loss
+ * additionally requires @ref rl_ringbuffer_file_sync.
+ *
+ * Requires POSIX mmap, enable with RL_RINGBUFFER_FILE_ENABLED.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_RINGBUFFER_FILE_H
+#define  RUUVI_LIBRARY_RINGBUFFER_FILE_H
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_enabled_modules.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if RL_RINGBUFFER_FILE_ENABLED || DOXYGEN
+
+/** @brief Identifies a ringbuffer file, "RLRB" in little endian. */
+#define RL_RINGBUFFER_FILE_MAGIC   (0x42524C52U)
+/** @brief Version of file layout, 2 stores head and tail as free-running counters. */
+#define RL_RINGBUFFER_FILE_VERSION (2U)
+
+/**
+ * @brief Handle of an open ringbuffer file.
+ */
+typedef struct
+{
+    rl_ringbuffer_t * buffer; //!< Ringbuffer inside the mapping, valid while open.
+    void * mapping;           //!< Start of mapped file.
+    size_t mapping_size;      //!< Size of mapped file in bytes.
+    int fd;                   //!< File descriptor of mapped file.
+} rl_ringbuffer_file_t;
+
+/**
+ * @brief Open or create a ringbuffer file and map it into memory.
+ *
+ * An empty or new file is initialized as an empty ringbuffer. An existing file
+ * is reopened with its head and tail, so previously queued elements can be
+ * dequeued. Per-process state such as cached indices and statistics starts over.
+ *
+ * Geometry and runtime hooks come from config: block_size, storage_size, index_mask,
+ * lock, writelock, readlock, policy and waiter. Storage, head and tail of config are
+ * ignored. The file records the geometry and the layout of @ref rl_ringbuffer_t and
+ * is rejected if they don't match, so it must be reopened by a build with the same
+ * RL_RINGBUFFER_CACHE_LINE_SIZE and RL_RINGBUFFER_STATS_ENABLED.
+ *
+ * \code{.c}
+ * static const rl_ringbuffer_t config = {.block_size = sizeof(rl_data_t),
+ *                                        .storage_size = 1024 * sizeof(rl_data_t),
+ *                                        .index_mask = 1023};
+ * rl_ringbuffer_file_t file;
+ * err_code |= rl_ringbuffer_file_open(&file, "/var/lib/collector/samples.rb", &config);
+ * err_code |= rl_ringbuffer_queue(file.buffer, &sample, sizeof(sample));
+ * \endcode
+ *
+ * @param[out] file Handle to initialize.
+ * @param[in]  path Path of file, created if it doesn't exist.
+ * @param[in]  config Geometry and hooks of ringbuffer.
+ * @retval     RL_SUCCESS File was opened.
+ * @retval     RL_ERROR_NULL Any input pointer is NULL.
+ * @retval     RL_ERROR_DATA_LENGTH Geometry of config is invalid, or existing file is
+ *                                  not a ringbuffer file or was created with different
+ *                                  geometry, layout or version. File is not modified.
+ * @retval     RL_ERROR_INTERNAL Head or tail stored in file is invalid.
+ * @retval     RL_ERROR_NO_MEM File could not be opened, resized or mapped.
+ */
+rl_status_t rl_ringbuffer_file_open (rl_ringbuffer_file_t * const file,
+                                     const char * const path,
+                                     const rl_ringbuffer_t * const config);
+
+/**
+ * @brief Flush mapping to disk.
+ *
+ * Storage is flushed before the ringbuffer with head and tail, so that after a
+ * power loss the indices never point to elements which didn't reach the disk.
+ * Call from the producer, an element queued between the two flushes breaks this order.
+ * Not needed to survive a crash of the process.
+ *
+ * @param[in] file Open ringbuffer file.
+ * @retval    RL_SUCCESS Mapping was written to disk.
+ * @retval    RL_ERROR_NULL File is NULL or not open.
+ * @retval    RL_ERROR_INTERNAL msync failed.
+ */
+rl_status_t rl_ringbuffer_file_sync (const rl_ringbuffer_file_t * const file);
+
+/**
+ * @brief Sync, unmap and close the ringbuffer file.
+ *
+ * @param[in,out] file Open ringbuffer file, buffer is NULL afterwards.
+ * @retval        RL_SUCCESS File was closed.
+ * @retval        RL_ERROR_NULL File is NULL or not open.
+ * @retval        RL_ERROR_INTERNAL File could not be synced or closed.
+ */
+rl_status_t rl_ringbuffer_file_close (rl_ringbuffer_file_t * const file);
+
+#endif
+
+/*@}*/
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file ruuvi_library_ringbuffer_mpmc.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Bounded multi-producer, multi-consumer ringbuffer.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Companion of @ref rl_ringbuffer_t for several producer and consumer threads.
+ * Every slot has a sequence number which tells whether the slot is free for the
+ * producer of the current lap or filled for the consumer of the current lap.
+ * Producers and consumers claim slots with compare-and-swap on head and tail,
+ * so contention costs a retry of the CAS instead of an RL_ERROR_CONCURRENCY
+ * returned to caller.
+ *
+ * The tradeoffs are that the storage and the number of elements must be powers
+ * of two, and the platform must provide lock-free compare-and-swap on size_t.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_RINGBUFFER_MPMC_H
+#define  RUUVI_LIBRARY_RINGBUFFER_MPMC_H
+
+#include "ruuvi_library.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* @brief Struct definition for multi-producer, multi-consumer ringbuffer.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static uint8_t buffer_data[1024];
+ * static _Atomic size_t buffer_seq[1024 / 32];
+ * static rl_ringbuffer_mpmc_t ringbuf = {.head = 0,
+ *                                        .tail = 0,
+ *                                        .block_size = 32,
+ *                                        .storage_size = sizeof(buffer_data),
+ *                                        .index_mask = (sizeof(buffer_data) / 32) - 1,
+ *                                        .storage = buffer_data,
+ *                                        .sequence = buffer_seq};
+ * rl_ringbuffer_mpmc_init(&ringbuf);
+ * \endcode
+ */
+typedef struct
+{
+    _Atomic size_t head;              //!< Number of slots claimed by producers.
+    _Atomic size_t tail;              //!< Number of slots claimed by consumers.
+    const size_t block_size;          //!< Block size of elements.
+    const size_t storage_size;        //!< Size of storage element, must be power of two.
+    const size_t index_mask;          //!< Bitmask of indexes. Must be (storage_size / block_size) -1
+    void * const storage;             //!< Pointer to storage.
+    _Atomic size_t * const sequence;  //!< Sequence number per slot, index_mask + 1 elements.
+} rl_ringbuffer_mpmc_t;
+
+/**
+ * @brief Reset ringbuffer to empty state.
+ *
+ * Must be called before first use and must not be called while other threads use
+ * the buffer.
+ *
+ * @param[in,out] buffer Ringbuffer to initialize.
+ * @retval RL_SUCCESS Buffer was initialized.
+ * @retval RL_ERROR_NULL Buffer, its storage or its sequence array is NULL.
+ */
+rl_status_t rl_ringbuffer_mpmc_init (rl_ringbuffer_mpmc_t * const buffer);
+
+/**
+ * @brief Queue data into ringbuffer
+ *
+ * This function operates on the head of the buffer, and rejects operation if
+ * there is no more room in the buffer. Safe to call from any number of threads.
+ *
+ * @param[in] buffer Pointer to ringbuffer to store data into
+ * @param[in] data Data to store
+ * @param[in] data_length length of data, at most @ref block_size.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_NO_MEM The ringbuffer was full.
+ * @retval    RL_ERROR_NULL  Data or buffer are NULL.
+ * @retval    RL_ERROR_DATA_LENGTH Data is bigger than buffer block size.
+ */
+rl_status_t rl_ringbuffer_mpmc_queue (rl_ringbuffer_mpmc_t * const buffer,
+                                      const void * const data,
+                                      const size_t data_length);
+
+/**
+ * @brief Dequeue data from ringbuffer
+ *
+ * This function operates on the tail of the buffer, and rejects operation if
+ * there is no more elements in the buffer. Safe to call from any number of threads.
+ *
+ * Unlike @ref rl_ringbuffer_dequeue this function copies the data out:
+ * the slot is handed back to producers as soon as the function returns and a pointer
+ * into storage would be overwritten by next lap of producers.
+ *
+ * @param[in,out] buffer Pointer to ringbuffer to load data from
+ * @param[out]    data Buffer to copy element into.
+ * @param[in]     data_length Number of bytes to copy, at most @ref block_size.
+ * @retval        RL_SUCCESS Data was dequeued.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_NO_DATA The ringbuffer was empty.
+ * @retval        RL_ERROR_DATA_LENGTH Data length is bigger than buffer block size.
+ */
+rl_status_t rl_ringbuffer_mpmc_dequeue (rl_ringbuffer_mpmc_t * const buffer,
+                                        void * const data,
+                                        const size_t data_length);
+
+/*
+ * return true if rinbuffer is full. Result is a snapshot under concurrent use.
+ */
+bool rl_ringbuffer_mpmc_full (const rl_ringbuffer_mpmc_t * const buffer);
+
+/*
+ * return true if rinbuffer is empty. Result is a snapshot under concurrent use.
+ */
+bool rl_ringbuffer_mpmc_empty (const rl_ringbuffer_mpmc_t * const buffer);
+
+/*@}*/
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file ruuvi_library_ringbuffer_sharded.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Ringbuffer sharded per core, with work-stealing consumers.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Companion of @ref rl_ringbuffer_t for many producer and consumer threads. The queue
+ * is an array of ringbuffers, typically one per core. Producers and consumers name
+ * their local shard, so threads on different cores don't contend for the same lock
+ * or cache lines. A consumer drains its local shard first and steals a batch of at
+ * most half of another shard's elements when the local shard is empty.
+ *
+ * There is no global FIFO order. Each shard is FIFO, so elements of a producer which
+ * always queues into the same shard are dequeued in the order they were queued.
+ *
+ * Every shard must have a lock function with read and write lock flags, as
+ * consumers of other shards read from it. Lock attempts don't busyloop: a shard
+ * which is busy is skipped by a stealing consumer.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_RINGBUFFER_SHARDED_H
+#define  RUUVI_LIBRARY_RINGBUFFER_SHARDED_H
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* @brief Struct definition for sharded ringbuffer.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static uint8_t shard_data[4][1024];
+ * static volatile uint32_t shard_wlock[4];
+ * static volatile uint32_t shard_rlock[4];
+ * static rl_ringbuffer_t shards[4] = {
+ *     {.block_size = 32, .storage_size = 1024, .index_mask = 31, .storage = shard_data[0],
+ *      .lock = platform_flag, .writelock = &shard_wlock[0], .readlock = &shard_rlock[0]},
+ *     ...
+ * };
+ * static rl_ringbuffer_sharded_t queue = {.shards = shards, .shard_count = 4};
+ * rl_ringbuffer_sharded_init(&queue);
+ * \endcode
+ */
+typedef struct
+{
+    rl_ringbuffer_t * const shards; //!< Array of shard_count ringbuffers.
+    const size_t shard_count;       //!< Number of shards.
+} rl_ringbuffer_sharded_t;
+
+/**
+ * @brief Reset every shard to empty state.
+ *
+ * Must be called before first use and must not be called while other threads use
+ * the buffer.
+ *
+ * @param[in,out] buffer Sharded ringbuffer to initialize.
+ * @retval RL_SUCCESS Buffer was initialized.
+ * @retval RL_ERROR_NULL Buffer or shard array is NULL, or a shard has no lock.
+ * @retval RL_ERROR_DATA_LENGTH There are no shards or shards have different block sizes.
+ */
+rl_status_t rl_ringbuffer_sharded_init (rl_ringbuffer_sharded_t * const buffer);
+
+/**
+ * @brief Queue data into a shard.
+ *
+ * A producer which always passes the same shard keeps its elements in order.
+ *
+ * @param[in] buffer Sharded ringbuffer to store data into.
+ * @param[in] shard Index of producer's shard.
+ * @param[in] data Data to store.
+ * @param[in] data_length Length of data, at most block size.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_DATA_LENGTH Shard index is out of range or data is too long.
+ * @retval    Error code from @ref rl_ringbuffer_queue of shard.
+ */
+rl_status_t rl_ringbuffer_sharded_queue (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        const void * const data,
+        const size_t data_length);
+
+/**
+ * @brief Queue several elements into a shard under one lock.
+ *
+ * @param[in] buffer Sharded ringbuffer to store data into.
+ * @param[in] shard Index of producer's shard.
+ * @param[in] data Elements to store, count * block_size bytes.
+ * @param[in] count Number of elements to store.
+ * @retval    RL_SUCCESS Data was queued.
+ * @retval    RL_ERROR_DATA_LENGTH Shard index is out of range.
+ * @retval    Error code from @ref rl_ringbuffer_queue_n of shard.
+ */
+rl_status_t rl_ringbuffer_sharded_queue_n (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        const void * const data,
+        const size_t count);
+
+/**
+ * @brief Dequeue a batch from local shard, or steal from other shards if it is empty.
+ *
+ * Other shards are visited in order starting after the local shard. From a victim
+ * at most half of its stored elements are taken, rounded up, so that its own
+ * consumer keeps work. All elements of one call come from one shard in FIFO order.
+ *
+ * @param[in,out] buffer Sharded ringbuffer to load data from.
+ * @param[in]     shard Index of consumer's local shard.
+ * @param[out]    data Buffer for elements, at least count * block_size bytes.
+ * @param[in,out] count In: Maximum number of elements to dequeue.
+ *                      Out: Number of elements dequeued.
+ * @retval        RL_SUCCESS Data was dequeued.
+ * @retval        RL_ERROR_NULL Any input pointer is NULL.
+ * @retval        RL_ERROR_DATA_LENGTH Shard index is out of range or count is 0.
+ * @retval        RL_ERROR_NO_DATA Every shard was empty.
+ * @retval        RL_ERROR_CONCURRENCY Nothing was dequeued and at least one shard was
+ *                                     locked by another thread, retry later.
+ * @retval        RL_ERROR_FATAL Lock could not be released.
+ */
+rl_status_t rl_ringbuffer_sharded_dequeue_n (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        void * const data,
+        size_t * const count);
+
+/*
+ * return number of elements in all shards, a snapshot while other threads run.
+ */
+size_t rl_ringbuffer_sharded_count (const rl_ringbuffer_sharded_t * const buffer);
+
+/*@}*/
+
+#endif
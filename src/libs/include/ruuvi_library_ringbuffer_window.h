@@ -0,0 +1,136 @@
+/**
+ * @file ruuvi_library_ringbuffer_window.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Sliding-window statistics maintained incrementally over a ringbuffer.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Companion of @ref rl_ringbuffer_t which keeps the last length float samples and
+ * updates statistics of the window as samples enter and leave it. Running sums give
+ * mean, variance and RMS, a @ref rl_peak2peak_window_t gives peak to peak.
+ * Each pushed sample costs O(1) amortized instead of the O(n) of @ref rl_rms,
+ * @ref rl_variance or @ref rl_peak2peak over the whole window.
+ *
+ * Sums are kept relative to a shift near the mean to avoid cancellation with
+ * large offsets, such as air pressure in Pa. Once per length samples the sums are
+ * recomputed from the stored samples, which bounds rounding drift without changing
+ * the amortized cost.
+ *
+ * Window is not thread-safe, push samples and read statistics from one thread.
+ */
+/*@{*/
+
+#ifndef  RUUVI_LIBRARY_RINGBUFFER_WINDOW_H
+#define  RUUVI_LIBRARY_RINGBUFFER_WINDOW_H
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+/// @cond 0
+#ifndef NAN
+#   error "NAN is not defined"
+#endif
+/// @endcond
+
+/* @brief Struct definition for sliding window.
+ *
+ * Samples ringbuffer must have block size of float and room for length samples,
+ * extrema must have the same length as window.
+ *
+ * Initialization example:
+ * \code{.c}
+ * static float sample_data[256];
+ * static rl_ringbuffer_t samples = {.head = 0, .tail = 0,
+ *                                   .block_size = sizeof(float),
+ *                                   .storage_size = sizeof(sample_data),
+ *                                   .index_mask = 255,
+ *                                   .storage = sample_data};
+ * static rl_peak2peak_extremum_t mins[200];
+ * static rl_peak2peak_extremum_t maxs[200];
+ * static rl_ringbuffer_window_t window = {.samples = &samples,
+ *                                         .length = 200,
+ *                                         .extrema = {.length = 200,
+ *                                                     .min = {.items = mins},
+ *                                                     .max = {.items = maxs}}};
+ * rl_ringbuffer_window_init(&window);
+ * \endcode
+ */
+typedef struct
+{
+    rl_ringbuffer_t * const samples;  //!< Samples currently in window, oldest at tail.
+    const size_t length;              //!< Number of samples in a full window.
+    rl_peak2peak_window_t extrema;    //!< Min and max of window.
+    size_t count;                     //!< Number of samples in window.
+    size_t nonfinite;                 //!< Number of NAN or infinite samples in window.
+    size_t since_refresh;             //!< Samples pushed since sums were recomputed.
+    float shift;                      //!< Offset subtracted from samples in sums.
+    float sum;                        //!< Sum of finite samples minus shift.
+    float sum_squares;                //!< Sum of squares of finite samples minus shift.
+} rl_ringbuffer_window_t;
+
+/**
+ * @brief Empty the window and its samples ringbuffer.
+ *
+ * @param[in,out] window Window to initialize.
+ * @retval RL_SUCCESS Window was initialized.
+ * @retval RL_ERROR_NULL Window, samples or deque storage is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Length is zero, larger than capacity of samples or
+ *                              not length of extrema, or block size of samples is
+ *                              not size of float.
+ */
+rl_status_t rl_ringbuffer_window_init (rl_ringbuffer_window_t * const window);
+
+/**
+ * @brief Add sample to window, evicting the oldest sample once window is full.
+ *
+ * Samples which are NAN or infinite are stored, statistics are NAN until they
+ * leave the window, like with @ref rl_rms.
+ *
+ * @param[in,out] window Window to update.
+ * @param[in]     sample New sample.
+ * @retval RL_SUCCESS Sample was added.
+ * @retval RL_ERROR_NULL Window is NULL.
+ * @retval Error code from samples ringbuffer, such as RL_ERROR_CONCURRENCY.
+ */
+rl_status_t rl_ringbuffer_window_push (rl_ringbuffer_window_t * const window,
+                                       const float sample);
+
+/**
+ * @brief Arithmetic mean of samples in window.
+ *
+ * @param[in] window Window to read.
+ * @return Mean, NAN if window is NULL, empty or has non-finite samples.
+ */
+float rl_ringbuffer_window_mean (const rl_ringbuffer_window_t * const window);
+
+/**
+ * @brief Variance of samples in window, same as @ref rl_variance over them.
+ *
+ * @param[in] window Window to read.
+ * @return Variance, NAN if window is NULL, empty or has non-finite samples.
+ */
+float rl_ringbuffer_window_variance (const rl_ringbuffer_window_t * const window);
+
+/**
+ * @brief Root mean square of samples in window, same as @ref rl_rms over them.
+ *
+ * @param[in] window Window to read.
+ * @return RMS, NAN if window is NULL, empty or has non-finite samples.
+ */
+float rl_ringbuffer_window_rms (const rl_ringbuffer_window_t * const window);
+
+/**
+ * @brief Difference of largest and smallest sample in window.
+ *
+ * @param[in] window Window to read.
+ * @return Peak to peak, NAN if window is NULL, empty or has non-finite samples.
+ */
+float rl_ringbuffer_window_peak2peak (const rl_ringbuffer_window_t * const window);
+
+/*@}*/
+
+#endif
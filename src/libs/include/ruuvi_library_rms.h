@@ -12,6 +12,7 @@
 #ifndef RUUVI_LIBRARY_RMS_H
 #define RUUVI_LIBRARY_RMS_H
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 /// @cond 0
 #ifndef NAN
@@ -32,5 +33,42 @@ error "NAN is not defined"
  */
 float rl_rms (const float * const data, const size_t data_length);
 
+/**
+ * @brief Calculate the RMS of every stride:th value, for example one axis of interleaved samples.
+ *
+ * Stride 1 is the same as @ref rl_rms.
+ *
+ * @param data[in] Pointer to first value
+ * @param data_length[in] Number of values
+ * @param stride[in] Distance between values in floats
+ * @return RMS of values, NAN if any of given values is NAN or input parameters are invalid
+ */
+float rl_rms_strided (const float * const data, const size_t data_length,
+                      const size_t stride);
+
+/**
+ * @brief Calculate the RMS of raw int16 counts, for example from ADC or accelerometer.
+ *
+ * Squares are summed exactly in int64 in one vectorized pass, only the result
+ * is converted.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values, less than 2^33
+ * @return RMS of counts, NAN if input parameters are invalid
+ */
+float rl_rms_i16 (const int16_t * const data, const size_t data_length);
+
+/**
+ * @brief Calculate the RMS of raw int32 counts.
+ *
+ * Squares don't fit int64, they are summed in double which is exact to the
+ * float result for any practical length.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values
+ * @return RMS of counts, NAN if input parameters are invalid
+ */
+float rl_rms_i32 (const int32_t * const data, const size_t data_length);
+
 /** @} */ // End of group analysis
 #endif
\ No newline at end of file
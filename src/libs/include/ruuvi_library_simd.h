@@ -0,0 +1,218 @@
+/**
+ * @file ruuvi_library_simd.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Vectorized reduction kernels of analysis functions, selected at runtime.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Reductions used by @ref rl_rms, @ref rl_variance and @ref rl_peak2peak. On first
+ * use the best implementation supported by the CPU is selected: AVX2 or SSE2 on x86
+ * with GCC or Clang, NEON on ARM cores which have it, and a portable scalar loop
+ * everywhere else, for example on Cortex-M MCUs.
+ *
+ * Vector kernels don't branch per element on finiteness. Each lane accumulates
+ * a mask of (x - x == 0), which is false for NAN and infinity, and the mask is
+ * reduced once at the end.
+ *
+ * Min and max are exact at every level. Vector sums add in 4 (SSE2, NEON) or
+ * 8 (AVX2) lanes, so sums differ from the scalar sequential order by rounding.
+ * For n terms of same sign the relative error bound of the sum improves from
+ * (n - 1) * FLT_EPSILON of the scalar loop to (n / lanes + log2(lanes)) * FLT_EPSILON,
+ * and RMS and variance stay within n * FLT_EPSILON relative difference of the scalar level.
+ *
+ * By default sums are accumulated pairwise: the kernel sums blocks of
+ * RL_SIMD_BLOCK_LENGTH values and block sums are added in a balanced tree. The
+ * bound becomes (RL_SIMD_BLOCK_LENGTH / lanes + log2(n / RL_SIMD_BLOCK_LENGTH))
+ * * FLT_EPSILON, so windows of millions of samples stay accurate in float. Inputs
+ * up to one block give the same result in both modes, longer ones cost a few
+ * percent of throughput. @ref RL_SIMD_ACCUMULATE_FLOAT sums everything in the
+ * kernel accumulators.
+ *
+ * Accumulation mode applies to float sums of @ref rl_rms, @ref rl_variance and
+ * their strided variants, and to @ref rl_stats, @ref rl_stats_strided and
+ * @ref rl_stats_interleaved. The stats functions sum blocks of rows in float and
+ * add the block sums in double instead of a tree, which keeps one set of sums per
+ * channel. @ref rl_moments_push_n and the parallel reductions built on it always
+ * merge blocks of 1024 values in double, the mode only changes how a block is
+ * summed. Integer variants are exact or summed in double and are not affected.
+ *
+ * Integer kernels of raw int16 counts are exact at every level and need no
+ * finiteness checks. They process 8 (SSE2, NEON) or 16 (AVX2) counts per step.
+ */
+
+#ifndef RUUVI_LIBRARY_SIMD_H
+#define RUUVI_LIBRARY_SIMD_H
+#include "ruuvi_library.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** @ingroup analysis
+ *  @{
+ */
+
+/**
+ * @brief Instruction set of reduction kernels.
+ */
+typedef enum
+{
+    RL_SIMD_SCALAR = 0, //!< Portable C loop.
+    RL_SIMD_SSE2,       //!< x86 SSE2, 4 lanes.
+    RL_SIMD_AVX2,       //!< x86 AVX2, 8 lanes.
+    RL_SIMD_NEON        //!< ARM NEON, 4 lanes.
+} rl_simd_level_t;
+
+/**
+ * @brief How sums of long inputs are accumulated.
+ */
+typedef enum
+{
+    RL_SIMD_ACCUMULATE_PAIRWISE = 0, //!< Kernel sums blocks, blocks are added pairwise.
+    RL_SIMD_ACCUMULATE_FLOAT         //!< Kernel sums whole input, fastest.
+} rl_simd_accumulation_t;
+
+#ifndef RL_SIMD_BLOCK_LENGTH
+/** @brief Values summed by kernel before pairwise accumulation, power of two. */
+#   define RL_SIMD_BLOCK_LENGTH (256U)
+#endif
+
+/**
+ * @brief Instruction set currently used, detected on first call.
+ */
+rl_simd_level_t rl_simd_level (void);
+
+/**
+ * @brief Override detected instruction set, for example to compare against scalar.
+ *
+ * Must not be called while other threads run analysis functions.
+ *
+ * @param[in] level Instruction set to use.
+ * @retval RL_SUCCESS Level is used by subsequent calls.
+ * @retval RL_ERROR_INTERNAL Level is not compiled in or not supported by CPU.
+ */
+rl_status_t rl_simd_select (const rl_simd_level_t level);
+
+/**
+ * @brief Accumulation mode currently used.
+ */
+rl_simd_accumulation_t rl_simd_accumulation (void);
+
+/**
+ * @brief Select accumulation mode of sums, for example to reproduce float results.
+ *
+ * Must not be called while other threads run analysis functions.
+ *
+ * @param[in] mode Accumulation mode to use.
+ * @retval RL_SUCCESS Mode is used by subsequent calls.
+ * @retval RL_ERROR_INTERNAL Mode is unknown.
+ */
+rl_status_t rl_simd_accumulation_select (const rl_simd_accumulation_t mode);
+
+/**
+ * @brief Sum of values.
+ *
+ * @param[in]  data Values to sum, not NULL.
+ * @param[in]  data_length Number of values.
+ * @param[out] sum Sum of values.
+ * @return true if every value is finite.
+ */
+bool rl_simd_sum (const float * const data, const size_t data_length,
+                  float * const sum);
+
+/**
+ * @brief Sum of squares of values.
+ *
+ * @param[in]  data Values to sum, not NULL.
+ * @param[in]  data_length Number of values.
+ * @param[out] sum Sum of squares of values.
+ * @return true if every value is finite.
+ */
+bool rl_simd_square_sum (const float * const data, const size_t data_length,
+                         float * const sum);
+
+/**
+ * @brief Sum of squared differences from mean, values are not checked for finiteness.
+ *
+ * @param[in] data Values to sum, not NULL.
+ * @param[in] data_length Number of values.
+ * @param[in] mean Value subtracted before squaring.
+ * @return Sum of squared differences.
+ */
+float rl_simd_deviation_square_sum (const float * const data, const size_t data_length,
+                                    const float mean);
+
+/**
+ * @brief Sum of every stride:th value.
+ *
+ * Strided blocks are summed by a scalar loop and accumulated like contiguous ones.
+ *
+ * @param[in]  data First value to sum, not NULL.
+ * @param[in]  data_length Number of values.
+ * @param[in]  stride Distance between values in floats, at least 1.
+ * @param[out] sum Sum of values.
+ * @return true if every value is finite.
+ */
+bool rl_simd_sum_strided (const float * const data, const size_t data_length,
+                          const size_t stride, float * const sum);
+
+/**
+ * @brief Sum of squares of every stride:th value.
+ *
+ * @param[in]  data First value to sum, not NULL.
+ * @param[in]  data_length Number of values.
+ * @param[in]  stride Distance between values in floats, at least 1.
+ * @param[out] sum Sum of squares of values.
+ * @return true if every value is finite.
+ */
+bool rl_simd_square_sum_strided (const float * const data, const size_t data_length,
+                                 const size_t stride, float * const sum);
+
+/**
+ * @brief Sum of squared differences of every stride:th value from mean.
+ *
+ * @param[in] data First value to sum, not NULL.
+ * @param[in] data_length Number of values.
+ * @param[in] stride Distance between values in floats, at least 1.
+ * @param[in] mean Value subtracted before squaring.
+ * @return Sum of squared differences.
+ */
+float rl_simd_deviation_square_sum_strided (const float * const data,
+        const size_t data_length, const size_t stride, const float mean);
+
+/**
+ * @brief Smallest and largest value.
+ *
+ * @param[in]  data Values to check, not NULL, at least one value.
+ * @param[in]  data_length Number of values.
+ * @param[out] min Smallest value.
+ * @param[out] max Largest value.
+ * @return true if every value is finite.
+ */
+bool rl_simd_min_max (const float * const data, const size_t data_length,
+                      float * const min, float * const max);
+
+/**
+ * @brief Exact sum of counts and of their squares.
+ *
+ * @param[in]  data Counts to sum, not NULL.
+ * @param[in]  data_length Number of counts, less than 2^33.
+ * @param[out] sum Sum of counts.
+ * @param[out] square_sum Sum of squares of counts.
+ */
+void rl_simd_sum_i16 (const int16_t * const data, const size_t data_length,
+                      int64_t * const sum, uint64_t * const square_sum);
+
+/**
+ * @brief Smallest and largest count.
+ *
+ * @param[in]  data Counts to check, not NULL, at least one count.
+ * @param[in]  data_length Number of counts.
+ * @param[out] min Smallest count.
+ * @param[out] max Largest count.
+ */
+void rl_simd_min_max_i16 (const int16_t * const data, const size_t data_length,
+                          int16_t * const min, int16_t * const max);
+
+/** @} */ // End of group analysis
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file ruuvi_library_stats.h
+ * @author Otso Jousimaa
+ * @date 2020-07-24
+ * @brief Function for calculating summary statistics of a signal sample in one pass.
+ * @copyright Copyright 2019 Ruuvi Innovations.
+ *   This project is released under the BSD-3-Clause License.
+ *
+ * Calculate mean, variance, RMS, min, max and peak to peak of a sample set while
+ * reading the data once, instead of once per @ref rl_variance (twice),
+ * @ref rl_rms and @ref rl_peak2peak.
+ */
+
+#ifndef RUUVI_LIBRARY_STATS_H
+#define RUUVI_LIBRARY_STATS_H
+#include "ruuvi_library.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/// @cond 0
+#ifndef NAN
+#   error "NAN is not defined"
+#endif
+/// @endcond
+
+/** @ingroup analysis
+ *  @{
+ */
+
+#ifndef RL_STATS_MAX_CHANNELS
+/** @brief Maximum number of channels in @ref rl_stats_interleaved. */
+#   define RL_STATS_MAX_CHANNELS (8U)
+#endif
+
+/**
+ * @brief Summary statistics of a sample set.
+ */
+typedef struct
+{
+    float mean;      //!< Arithmetic mean.
+    float variance;  //!< Variance, as @ref rl_variance.
+    float rms;       //!< Root mean square, as @ref rl_rms.
+    float min;       //!< Smallest value.
+    float max;       //!< Largest value.
+    float peak2peak; //!< Difference between max and min, as @ref rl_peak2peak.
+} rl_stats_t;
+
+/**
+ * @brief Calculate summary statistics of a given sample set in a single pass.
+ *
+ * Same as @ref rl_stats_strided with stride 1.
+ * Variance is accumulated around the first value instead of the mean, so it may
+ * differ from @ref rl_variance by rounding. Sums are taken in float over blocks of
+ * RL_SIMD_BLOCK_LENGTH rows and blocks are added in double, or in float over the
+ * whole input if @ref RL_SIMD_ACCUMULATE_FLOAT is selected. A field which overflows
+ * is NAN, as with the single functions.
+ *
+ * @param data[in] Pointer to floats with values to check
+ * @param data_length[in] Number of values
+ * @param stats[out] Statistics of values, every field NAN if function fails.
+ * @retval RL_SUCCESS Statistics were calculated.
+ * @retval RL_ERROR_NULL Data or stats is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Data length is zero.
+ * @retval RL_ERROR_NO_DATA Any of given values is NAN or infinite.
+ */
+rl_status_t rl_stats (const float * const data, const size_t data_length,
+                      rl_stats_t * const stats);
+
+/**
+ * @brief Calculate summary statistics of every stride:th value, without copying.
+ *
+ * Values are data[0], data[stride], ... data[(data_length - 1) * stride].
+ *
+ * @param data[in] Pointer to first value
+ * @param data_length[in] Number of values
+ * @param stride[in] Distance between values in floats, 1 for contiguous values.
+ * @param stats[out] Statistics of values, every field NAN if function fails.
+ * @retval RL_SUCCESS Statistics were calculated.
+ * @retval RL_ERROR_NULL Data or stats is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Data length or stride is zero.
+ * @retval RL_ERROR_NO_DATA Any of given values is NAN or infinite.
+ */
+rl_status_t rl_stats_strided (const float * const data, const size_t data_length,
+                              const size_t stride, rl_stats_t * const stats);
+
+/**
+ * @brief Calculate summary statistics of interleaved channels in a single pass.
+ *
+ * Rows of stride floats hold channels consecutive values at their start, for
+ * example the payload of @ref rl_data_t samples:
+ *
+ * @code{.c}
+ * rl_data_t samples[128];
+ * rl_stats_t axes[RL_COMPRESS_FIELD_NUM];
+ * rl_stats_interleaved (samples[0].payload, 128, sizeof (rl_data_t) / sizeof (float),
+ *                       RL_COMPRESS_FIELD_NUM, axes);
+ * @endcode
+ *
+ * A channel with a NAN or infinite value is left NAN, other channels are still
+ * calculated.
+ *
+ * @param data[in] Pointer to first value of first row
+ * @param data_length[in] Number of rows
+ * @param stride[in] Distance between rows in floats, at least channels.
+ * @param channels[in] Number of channels, at most RL_STATS_MAX_CHANNELS.
+ * @param stats[out] Array of channels statistics.
+ * @retval RL_SUCCESS Statistics were calculated.
+ * @retval RL_ERROR_NULL Data or stats is NULL.
+ * @retval RL_ERROR_DATA_LENGTH Data length or channels is zero, or channels
+ *                              doesn't fit in stride or RL_STATS_MAX_CHANNELS.
+ * @retval RL_ERROR_NO_DATA Any channel had a NAN or infinite value.
+ */
+rl_status_t rl_stats_interleaved (const float * const data, const size_t data_length,
+                                  const size_t stride, const size_t channels,
+                                  rl_stats_t * const stats);
+
+/** @} */ // End of group analysis
+#endif
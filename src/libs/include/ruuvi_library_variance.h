@@ -12,6 +12,7 @@
 #ifndef RUUVI_LIBRARY_VARIANCE_H
 #define RUUVI_LIBRARY_VARIANCE_H
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 /// @cond 0
 #ifndef NAN
@@ -32,5 +33,41 @@ error "NAN is not defined"
  */
 float rl_variance (const float * const data, const size_t data_length);
 
+/**
+ * @brief Calculate the variance of every stride:th value.
+ *
+ * Stride 1 is the same as @ref rl_variance.
+ *
+ * @param data[in] Pointer to first value
+ * @param data_length[in] Number of values
+ * @param stride[in] Distance between values in floats
+ * @return Variance of values, NAN if any of given values is NAN or input parameters are invalid
+ */
+float rl_variance_strided (const float * const data, const size_t data_length,
+                           const size_t stride);
+
+/**
+ * @brief Calculate the variance of raw int16 counts.
+ *
+ * Counts and their squares are summed exactly in int64 in one vectorized pass,
+ * only the result is converted.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values, less than 2^33
+ * @return Variance of counts, NAN if input parameters are invalid
+ */
+float rl_variance_i16 (const int16_t * const data, const size_t data_length);
+
+/**
+ * @brief Calculate the variance of raw int32 counts.
+ *
+ * Differences from first count are summed exactly in int64, their squares in double.
+ *
+ * @param data[in] Pointer to counts
+ * @param data_length[in] Number of values, less than 2^31
+ * @return Variance of counts, NAN if input parameters are invalid
+ */
+float rl_variance_i32 (const int32_t * const data, const size_t data_length);
+
 /** @} */ // End of group analysis
 #endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+// See header file for copyright etc.
+
+#include "ruuvi_library_moments.h"
+#include "ruuvi_library_simd.h"
+#include <math.h>
+
+/** @brief Samples reduced in float per block before merging into double state. */
+#define MOMENTS_BLOCK (1024U)
+
+static inline float finite_or_nan (const double value)
+{
+    const float result = (float) value;
+    return isfinite (result) ? result : NAN;
+}
+
+/**
+ * @brief Chan's parallel update with statistics of a block of finite samples.
+ */
+static void merge_block (rl_moments_t * const moments, const uint64_t count,
+                         const double mean, const double m2,
+                         const float min, const float max)
+{
+    if (0 == moments->count)
+    {
+        moments->mean = mean;
+        moments->m2 = m2;
+        moments->min = min;
+        moments->max = max;
+    }
+    else
+    {
+        const double total = (double) (moments->count + count);
+        const double delta = mean - moments->mean;
+        moments->mean += delta * ( (double) count / total);
+        moments->m2 += m2 + (delta * delta * ( (double) moments->count * (double) count / total));
+        moments->min = (min < moments->min) ? min : moments->min;
+        moments->max = (max > moments->max) ? max : moments->max;
+    }
+
+    moments->count += count;
+}
+
+rl_status_t rl_moments_init (rl_moments_t * const moments)
+{
+    if (NULL == moments) { return RL_ERROR_NULL; }
+
+    moments->count = 0;
+    moments->mean = 0;
+    moments->m2 = 0;
+    moments->min = NAN;
+    moments->max = NAN;
+    moments->finite = true;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_moments_push (rl_moments_t * const moments, const float value)
+{
+    if (NULL == moments) { return RL_ERROR_NULL; }
+
+    if (!isfinite (value))
+    {
+        moments->finite = false;
+        moments->count++;
+    }
+    else if (0 == moments->count)
+    {
+        merge_block (moments, 1, value, 0, value, value);
+    }
+    else
+    {
+        // Welford's update.
+        const double delta = value - moments->mean;
+        moments->count++;
+        moments->mean += delta / (double) moments->count;
+        moments->m2 += delta * (value - moments->mean);
+        moments->min = (value < moments->min) ? value : moments->min;
+        moments->max = (value > moments->max) ? value : moments->max;
+    }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_moments_push_n (rl_moments_t * const moments, const float * const data,
+                               const size_t data_length)
+{
+    if (NULL == moments || NULL == data) { return RL_ERROR_NULL; }
+
+    for (size_t start = 0; start < data_length; start += MOMENTS_BLOCK)
+    {
+        const size_t count = ( (data_length - start) < MOMENTS_BLOCK) ?
+                             (data_length - start) : MOMENTS_BLOCK;
+        const float * const p_block = &data[start];
+        float min = 0;
+        float max = 0;
+        float sum = 0;
+
+        if (!rl_simd_min_max (p_block, count, &min, &max))
+        {
+            moments->finite = false;
+            moments->count += count;
+            continue;
+        }
+
+        rl_simd_sum (p_block, count, &sum);
+        const float mean = sum / count;
+        const float m2 = rl_simd_deviation_square_sum (p_block, count, mean);
+        merge_block (moments, count, mean, m2, min, max);
+    }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_moments_merge (rl_moments_t * const target,
+                              const rl_moments_t * const source)
+{
+    if (NULL == target || NULL == source) { return RL_ERROR_NULL; }
+
+    if (!source->finite)
+    {
+        target->finite = false;
+        target->count += source->count;
+    }
+    else if (0 < source->count)
+    {
+        merge_block (target, source->count, source->mean, source->m2, source->min,
+                     source->max);
+    }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_moments_finalize (const rl_moments_t * const moments,
+                                 rl_stats_t * const stats)
+{
+    if (NULL == stats) { return RL_ERROR_NULL; }
+
+    stats->mean = NAN;
+    stats->variance = NAN;
+    stats->rms = NAN;
+    stats->min = NAN;
+    stats->max = NAN;
+    stats->peak2peak = NAN;
+
+    if (NULL == moments) { return RL_ERROR_NULL; }
+
+    if ( (0 == moments->count) || !moments->finite) { return RL_ERROR_NO_DATA; }
+
+    const double variance = moments->m2 / (double) moments->count;
+    stats->mean = finite_or_nan (moments->mean);
+    stats->variance = finite_or_nan (variance);
+    stats->rms = finite_or_nan (sqrt (variance + (moments->mean * moments->mean)));
+    stats->min = moments->min;
+    stats->max = moments->max;
+    stats->peak2peak = finite_or_nan ( (double) moments->max - (double) moments->min);
+    return RL_SUCCESS;
+}
@@ -0,0 +1,218 @@
+#ifndef _POSIX_C_SOURCE
+#   define _POSIX_C_SOURCE 200809L
+#endif
+// See header file for copyright etc.
+
+#include "ruuvi_library_parallel.h"
+#if RL_PARALLEL_ENABLED
+
+#include "ruuvi_library_moments.h"
+#include <math.h>
+
+/**
+ * @brief Job of reducing one array into per-part moments.
+ */
+typedef struct
+{
+    const float * data;                             //!< Samples to reduce.
+    size_t data_length;                             //!< Number of samples.
+    rl_moments_t partial[RL_PARALLEL_MAX_WORKERS + 1]; //!< Result of every part.
+} moments_job_t;
+
+static void * worker (void * arg)
+{
+    rl_parallel_pool_t * const pool = (rl_parallel_pool_t *) arg;
+    // Workers start before the first job, a job posted before this thread runs is not missed.
+    uint32_t seen = 0;
+    pthread_mutex_lock (&pool->mutex);
+
+    while (true)
+    {
+        while (!pool->stop && (seen == pool->generation))
+        {
+            pthread_cond_wait (&pool->start, &pool->mutex);
+        }
+
+        if (pool->stop) { break; }
+
+        seen = pool->generation;
+        const size_t part = pool->next_part++;
+        const rl_parallel_task_fp task = pool->task;
+        void * const context = pool->context;
+        pthread_mutex_unlock (&pool->mutex);
+        task (context, part, pool->workers + 1U);
+        pthread_mutex_lock (&pool->mutex);
+
+        if (0 == --pool->pending)
+        {
+            pthread_cond_signal (&pool->done);
+        }
+    }
+
+    pthread_mutex_unlock (&pool->mutex);
+    return NULL;
+}
+
+/**
+ * @brief First sample of part, first length % parts parts take one extra sample.
+ *
+ * Length * part would overflow 32-bit size_t for long arrays.
+ */
+static size_t part_start (const size_t length, const size_t part, const size_t parts)
+{
+    const size_t remainder = length % parts;
+    return (part * (length / parts)) + ( (part < remainder) ? part : remainder);
+}
+
+static void moments_task (void * const context, const size_t part, const size_t parts)
+{
+    moments_job_t * const job = (moments_job_t *) context;
+    const size_t start = part_start (job->data_length, part, parts);
+    const size_t end = part_start (job->data_length, part + 1U, parts);
+    // Accumulate locally, parts write their slots only once to avoid false sharing.
+    rl_moments_t moments;
+    rl_moments_init (&moments);
+    rl_moments_push_n (&moments, &job->data[start], end - start);
+    job->partial[part] = moments;
+}
+
+rl_status_t rl_parallel_init (rl_parallel_pool_t * const pool, const size_t workers)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == pool)                      { return RL_ERROR_NULL; }
+
+    if (RL_PARALLEL_MAX_WORKERS < workers) { return RL_ERROR_DATA_LENGTH; }
+
+    pthread_mutex_init (&pool->mutex, NULL);
+    pthread_cond_init (&pool->start, NULL);
+    pthread_cond_init (&pool->done, NULL);
+    pool->generation = 0;
+    pool->next_part = 0;
+    pool->pending = 0;
+    pool->stop = false;
+    pool->task = NULL;
+    pool->context = NULL;
+    pool->workers = 0;
+
+    for (size_t ii = 0; (ii < workers) && (RL_SUCCESS == err_code); ii++)
+    {
+        if (0 == pthread_create (&pool->threads[ii], NULL, &worker, pool))
+        {
+            pool->workers++;
+        }
+        else
+        {
+            err_code |= RL_ERROR_NO_MEM;
+        }
+    }
+
+    if (RL_SUCCESS != err_code)
+    {
+        rl_parallel_uninit (pool);
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_parallel_uninit (rl_parallel_pool_t * const pool)
+{
+    if (NULL == pool) { return RL_ERROR_NULL; }
+
+    pthread_mutex_lock (&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast (&pool->start);
+    pthread_mutex_unlock (&pool->mutex);
+
+    for (size_t ii = 0; ii < pool->workers; ii++)
+    {
+        pthread_join (pool->threads[ii], NULL);
+    }
+
+    pool->workers = 0;
+    pthread_cond_destroy (&pool->done);
+    pthread_cond_destroy (&pool->start);
+    pthread_mutex_destroy (&pool->mutex);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_parallel_run (rl_parallel_pool_t * const pool,
+                             const rl_parallel_task_fp task, void * const context)
+{
+    if (NULL == pool || NULL == task) { return RL_ERROR_NULL; }
+
+    pthread_mutex_lock (&pool->mutex);
+    pool->task = task;
+    pool->context = context;
+    pool->next_part = 0;
+    pool->pending = pool->workers;
+    pool->generation++;
+    pthread_cond_broadcast (&pool->start);
+    pthread_mutex_unlock (&pool->mutex);
+    // Caller takes the last part instead of idling.
+    task (context, pool->workers, pool->workers + 1U);
+    pthread_mutex_lock (&pool->mutex);
+
+    while (0 < pool->pending)
+    {
+        pthread_cond_wait (&pool->done, &pool->mutex);
+    }
+
+    pthread_mutex_unlock (&pool->mutex);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_parallel_moments (rl_parallel_pool_t * const pool,
+                                 const float * const data, const size_t data_length,
+                                 rl_moments_t * const moments)
+{
+    moments_job_t job = {.data = data, .data_length = data_length};
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == pool || NULL == data || NULL == moments) { return RL_ERROR_NULL; }
+
+    err_code |= rl_parallel_run (pool, &moments_task, &job);
+
+    for (size_t ii = 0; ii <= pool->workers; ii++)
+    {
+        err_code |= rl_moments_merge (moments, &job.partial[ii]);
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_parallel_stats (rl_parallel_pool_t * const pool,
+                               const float * const data, const size_t data_length,
+                               rl_stats_t * const stats)
+{
+    rl_moments_t moments;
+    rl_status_t err_code = rl_moments_init (&moments);
+    // Fills stats with NAN, empty moments are never valid.
+    err_code |= rl_moments_finalize (&moments, stats);
+
+    if (NULL == stats || NULL == pool || NULL == data) { return RL_ERROR_NULL; }
+
+    if (0 == data_length)                             { return RL_ERROR_DATA_LENGTH; }
+
+    err_code = rl_parallel_moments (pool, data, data_length, &moments);
+    err_code |= rl_moments_finalize (&moments, stats);
+    return err_code;
+}
+
+float rl_parallel_rms (rl_parallel_pool_t * const pool,
+                       const float * const data, const size_t data_length)
+{
+    rl_stats_t stats;
+    rl_parallel_stats (pool, data, data_length, &stats);
+    return stats.rms;
+}
+
+float rl_parallel_variance (rl_parallel_pool_t * const pool,
+                            const float * const data, const size_t data_length)
+{
+    rl_stats_t stats;
+    rl_parallel_stats (pool, data, data_length, &stats);
+    return stats.variance;
+}
+
+#endif
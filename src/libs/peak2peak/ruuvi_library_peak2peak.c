@@ -1,6 +1,7 @@
 // See header file for copyright etc.
 
 #include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_simd.h"
 #include <float.h>
 #include <math.h>
 
@@ -8,21 +9,178 @@ float rl_peak2peak (const float * const data, const size_t data_length)
 {
     if (NULL == data || 0 == data_length) { return NAN; }
 
-    float min = FLT_MAX;
-    float max = FLT_MIN;
+    float min = data[0];
+    float max = data[0];
+
+    if (!rl_simd_min_max (data, data_length, &min, &max)) { return NAN; }
+
+    float result = max - min;
+
+    if (!isfinite (result)) { return NAN; }
+
+    return result;
+}
+
+float rl_peak2peak_i16 (const int16_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    int16_t min = data[0];
+    int16_t max = data[0];
+    rl_simd_min_max_i16 (data, data_length, &min, &max);
+    return (float) (max - min);
+}
+
+float rl_peak2peak_i32 (const int32_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    int32_t min = data[0];
+    int32_t max = data[0];
 
     for (size_t ii = 0; ii < data_length; ii++)
     {
-        if (!isfinite (data[ii])) { return NAN; }
+        min = (data[ii] < min) ? data[ii] : min;
+        max = (data[ii] > max) ? data[ii] : max;
+    }
 
-        if (data[ii] < min) { min = data[ii]; }
+    return (float) ( (int64_t) max - min);
+}
 
-        if (data[ii] > max) { max = data[ii]; }
+float rl_peak2peak_strided (const float * const data, const size_t data_length,
+                            const size_t stride)
+{
+    if (NULL == data || 0 == data_length || 0 == stride) { return NAN; }
+
+    if (1U == stride) { return rl_peak2peak (data, data_length); }
+
+    float min = data[0];
+    float max = data[0];
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const float value = data[ii * stride];
+
+        if (!isfinite (value)) { return NAN; }
+
+        if (value < min) { min = value; }
+
+        if (value > max) { max = value; }
     }
 
-    float result = max - min;
+    const float result = max - min;
+    return isfinite (result) ? result : NAN;
+}
 
-    if (!isfinite (result)) { return NAN; }
+static inline rl_peak2peak_extremum_t * deque_at (const rl_peak2peak_window_t * const
+        window, const rl_peak2peak_deque_t * const deque, const size_t index)
+{
+    // First and index are below length, wrap with a subtraction instead of division.
+    const size_t position = deque->first + index;
+    return &deque->items[ (position < window->length) ? position : position - window->length];
+}
 
-    return result;
-}
\ No newline at end of file
+/**
+ * @brief Add candidate, dropping older candidates which can no longer be the extremum.
+ *
+ * Candidates that are not larger (max) or not smaller (min) than the new sample
+ * leave the window before it, so deque stays monotonic.
+ */
+static void deque_push (const rl_peak2peak_window_t * const window,
+                        rl_peak2peak_deque_t * const deque,
+                        const float value, const uint32_t sequence, const bool is_max)
+{
+    while (0 < deque->count)
+    {
+        const float last = deque_at (window, deque, deque->count - 1)->value;
+
+        if (is_max ? (last > value) : (last < value)) { break; }
+
+        deque->count--;
+    }
+
+    rl_peak2peak_extremum_t * const p_item = deque_at (window, deque, deque->count);
+    p_item->value = value;
+    p_item->sequence = sequence;
+    deque->count++;
+}
+
+/**
+ * @brief Drop oldest candidate if it leaves the window when sample sequence enters.
+ *
+ * Only one sample leaves per push, so at most one candidate is dropped.
+ */
+static void deque_evict (const rl_peak2peak_window_t * const window,
+                         rl_peak2peak_deque_t * const deque, const uint32_t sequence)
+{
+    if (0 < deque->count)
+    {
+        // Unsigned difference is correct across sequence wrap-around.
+        const uint32_t age = sequence - deque_at (window, deque, 0)->sequence;
+
+        if (window->length <= (size_t) age)
+        {
+            deque->first = (deque->first + 1U < window->length) ? deque->first + 1U : 0U;
+            deque->count--;
+        }
+    }
+}
+
+rl_status_t rl_peak2peak_window_init (rl_peak2peak_window_t * const window)
+{
+    if (NULL == window || NULL == window->min.items || NULL == window->max.items)
+    {
+        return RL_ERROR_NULL;
+    }
+
+    if ( (0 == window->length) || ( (uint64_t) UINT32_MAX < (uint64_t) window->length))
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    window->min.first = 0;
+    window->min.count = 0;
+    window->max.first = 0;
+    window->max.count = 0;
+    window->count = 0;
+    window->finite_run = 0;
+    window->sequence = 0;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_peak2peak_window_push (rl_peak2peak_window_t * const window,
+                                      const float sample)
+{
+    if (NULL == window) { return RL_ERROR_NULL; }
+
+    const uint32_t sequence = window->sequence;
+    window->sequence++;
+    deque_evict (window, &window->min, sequence);
+    deque_evict (window, &window->max, sequence);
+
+    if (isfinite (sample))
+    {
+        deque_push (window, &window->min, sample, sequence, false);
+        deque_push (window, &window->max, sample, sequence, true);
+        window->finite_run += (window->finite_run < window->length) ? 1U : 0U;
+    }
+    else
+    {
+        window->finite_run = 0;
+    }
+
+    window->count += (window->count < window->length) ? 1U : 0U;
+    return RL_SUCCESS;
+}
+
+float rl_peak2peak_window_value (const rl_peak2peak_window_t * const window)
+{
+    if (NULL == window || 0 == window->count || window->finite_run < window->count)
+    {
+        return NAN;
+    }
+
+    const float result = deque_at (window, &window->max, 0)->value
+                         - deque_at (window, &window->min, 0)->value;
+    return isfinite (result) ? result : NAN;
+}
@@ -0,0 +1,243 @@
+// See header file for copyright etc.
+
+#include "ruuvi_library_quantile.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define CAPACITY (RL_QUANTILE_CENTROIDS + RL_QUANTILE_BUFFER) //!< Centroids in state.
+
+/**
+ * @brief Compression of digest.
+ *
+ * Consecutive compressed centroids span more than 1 in the scale function, which
+ * ranges over COMPRESSION / 2. Hence there are at most COMPRESSION + 1 of them.
+ */
+#define COMPRESSION ((double) RL_QUANTILE_CENTROIDS - 1.0)
+#define PI (3.14159265358979323846) //!< M_PI is not part of C11.
+
+static int centroid_compare (const void * a, const void * b)
+{
+    const float left = ( (const rl_quantile_centroid_t *) a)->mean;
+    const float right = ( (const rl_quantile_centroid_t *) b)->mean;
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief t-digest k1 scale function, steep near 0 and 1 to keep tail centroids small.
+ */
+static double scale (const double q)
+{
+    const double limited = (q < 0.0) ? 0.0 : ( (q > 1.0) ? 1.0 : q);
+    return (COMPRESSION / (2.0 * PI)) * asin ( (2.0 * limited) - 1.0);
+}
+
+/**
+ * @brief Sort compressed and buffered centroids together and merge neighbours.
+ *
+ * Merging is done in place, write index never passes read index.
+ */
+static void compress (rl_quantile_t * const quantile)
+{
+    const size_t total = quantile->compressed + quantile->buffered;
+    rl_quantile_centroid_t * const items = quantile->centroids;
+
+    if (0 == quantile->buffered) { return; }
+
+    uint64_t total_count = 0;
+
+    // Count of items differs from quantile count while a merge is in progress.
+    for (size_t ii = 0; ii < total; ii++)
+    {
+        total_count += items[ii].count;
+    }
+
+    qsort (items, total, sizeof (items[0]), &centroid_compare);
+
+    // Everything fits, keep samples exact.
+    if (RL_QUANTILE_CENTROIDS >= total)
+    {
+        quantile->compressed = total;
+        quantile->buffered = 0;
+        return;
+    }
+
+    double weight_before = 0;
+    double k_left = scale (0.0);
+    size_t out = 0;
+    rl_quantile_centroid_t current = items[0];
+
+    for (size_t ii = 1; ii < total; ii++)
+    {
+        const uint64_t proposed = (uint64_t) current.count + items[ii].count;
+        const double k_right = scale ( (weight_before + (double) proposed)
+                                       / (double) total_count);
+
+        if ( ( (k_right - k_left) <= 1.0) && (proposed <= UINT32_MAX))
+        {
+            current.mean += (items[ii].mean - current.mean)
+                            * ( (float) items[ii].count / (float) proposed);
+            current.count = (uint32_t) proposed;
+        }
+        else
+        {
+            items[out] = current;
+            out++;
+            weight_before += current.count;
+            k_left = scale (weight_before / (double) total_count);
+            current = items[ii];
+        }
+    }
+
+    items[out] = current;
+    quantile->compressed = out + 1U;
+    quantile->buffered = 0;
+}
+
+/**
+ * @brief Append centroid to buffer, compressing first if buffer is full.
+ */
+static void centroid_add (rl_quantile_t * const quantile,
+                          const rl_quantile_centroid_t * const centroid)
+{
+    if (CAPACITY <= (quantile->compressed + quantile->buffered))
+    {
+        compress (quantile);
+    }
+
+    quantile->centroids[quantile->compressed + quantile->buffered] = *centroid;
+    quantile->buffered++;
+}
+
+rl_status_t rl_quantile_init (rl_quantile_t * const quantile)
+{
+    if (NULL == quantile) { return RL_ERROR_NULL; }
+
+    quantile->compressed = 0;
+    quantile->buffered = 0;
+    quantile->count = 0;
+    quantile->min = NAN;
+    quantile->max = NAN;
+    quantile->finite = true;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_quantile_push (rl_quantile_t * const quantile, const float value)
+{
+    if (NULL == quantile) { return RL_ERROR_NULL; }
+
+    if (!isfinite (value))
+    {
+        quantile->finite = false;
+        return RL_SUCCESS;
+    }
+
+    const rl_quantile_centroid_t centroid = {.mean = value, .count = 1};
+
+    if ( (0 == quantile->count) || (value < quantile->min)) { quantile->min = value; }
+
+    if ( (0 == quantile->count) || (value > quantile->max)) { quantile->max = value; }
+
+    quantile->count++;
+    centroid_add (quantile, &centroid);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_quantile_push_n (rl_quantile_t * const quantile,
+                                const float * const data, const size_t data_length)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == quantile || NULL == data) { return RL_ERROR_NULL; }
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        err_code |= rl_quantile_push (quantile, data[ii]);
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_quantile_merge (rl_quantile_t * const quantile,
+                               const rl_quantile_t * const other)
+{
+    if (NULL == quantile || NULL == other) { return RL_ERROR_NULL; }
+
+    quantile->finite = quantile->finite && other->finite;
+
+    if (0 == other->count) { return RL_SUCCESS; }
+
+    if ( (0 == quantile->count) || (other->min < quantile->min)) { quantile->min = other->min; }
+
+    if ( (0 == quantile->count) || (other->max > quantile->max)) { quantile->max = other->max; }
+
+    quantile->count += other->count;
+
+    // Adding own centroids would walk an array which grows and gets compressed
+    // meanwhile. Every sample counts twice instead, distribution stays the same.
+    if (quantile == other)
+    {
+        for (size_t ii = 0; ii < (quantile->compressed + quantile->buffered); ii++)
+        {
+            quantile->centroids[ii].count *= 2U;
+        }
+
+        return RL_SUCCESS;
+    }
+
+    for (size_t ii = 0; ii < (other->compressed + other->buffered); ii++)
+    {
+        centroid_add (quantile, &other->centroids[ii]);
+    }
+
+    return RL_SUCCESS;
+}
+
+float rl_quantile_value (rl_quantile_t * const quantile, const float q)
+{
+    if (NULL == quantile || 0 == quantile->count || !quantile->finite
+            || !(q >= 0.0F && q <= 1.0F))
+    {
+        return NAN;
+    }
+
+    compress (quantile);
+    const rl_quantile_centroid_t * const items = quantile->centroids;
+    const size_t last = quantile->compressed - 1U;
+    const double target = (double) q * (double) quantile->count;
+    // Centroid i covers ranks around its center, weight before it plus half of its own.
+    double center = items[0].count / 2.0;
+    double result = quantile->max;
+
+    if (target <= center)
+    {
+        // Between min at rank 0 and first centroid.
+        result = quantile->min + ( (items[0].mean - quantile->min) * (target / center));
+    }
+    else
+    {
+        size_t ii = 0;
+
+        while ( (ii < last)
+                && (target > (center + ( (items[ii].count + items[ii + 1U].count) / 2.0))))
+        {
+            center += (items[ii].count + items[ii + 1U].count) / 2.0;
+            ii++;
+        }
+
+        if (ii < last)
+        {
+            const double next = center + ( (items[ii].count + items[ii + 1U].count) / 2.0);
+            const double fraction = (target - center) / (next - center);
+            result = items[ii].mean + ( (items[ii + 1U].mean - items[ii].mean) * fraction);
+        }
+        else
+        {
+            // Between last centroid and max at rank count.
+            const double span = (double) quantile->count - center;
+            result = items[last].mean + ( (quantile->max - items[last].mean)
+                                          * ( (target - center) / span));
+        }
+    }
+
+    return (float) result;
+}
@@ -0,0 +1,237 @@
+#include "ruuvi_library.h"
+#include "ruuvi_library_bipbuffer.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#define NO_RESERVATION (SIZE_MAX) //!< Value of reserved when producer has no record open.
+
+/**
+ * @brief Acquire or release a buffer lock, NULL lock function is lock-free mode.
+ */
+static inline bool buffer_lock (const rl_bipbuffer_t * const buffer,
+                                volatile void * const flag, const bool set)
+{
+    return (NULL == buffer->lock) || buffer->lock (flag, set);
+}
+
+/**
+ * @brief Return read offset of oldest record, following the writer to start of
+ *        storage once all data before watermark has been read.
+ *
+ * @param[in,out] buffer Buffer to read.
+ * @param[out] p_head Write offset seen by consumer.
+ */
+static size_t read_offset (rl_bipbuffer_t * const buffer, size_t * const p_head)
+{
+    // Acquire on head makes watermark and record contents written before it visible.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    const size_t watermark = atomic_load_explicit (&buffer->watermark,
+                             memory_order_acquire);
+    size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+
+    if ( (tail == watermark) && (head < tail))
+    {
+        tail = 0;
+        atomic_store_explicit (&buffer->tail, tail, memory_order_release);
+    }
+
+    *p_head = head;
+    return tail;
+}
+
+rl_status_t rl_bipbuffer_init (rl_bipbuffer_t * const buffer)
+{
+    if (NULL == buffer || NULL == buffer->storage) { return RL_ERROR_NULL; }
+
+    if (0 != (buffer->storage_size & (RL_BIPBUFFER_ALIGN - 1U)))
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    buffer->reserved = NO_RESERVATION;
+    atomic_store_explicit (&buffer->watermark, buffer->storage_size,
+                           memory_order_relaxed);
+    atomic_store_explicit (&buffer->head, 0, memory_order_relaxed);
+    atomic_store_explicit (&buffer->tail, 0, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_bipbuffer_reserve (rl_bipbuffer_t * const buffer,
+                                  const size_t data_length,
+                                  void * const data)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    // Bound length before rounding it up so that record size cannot overflow.
+    if ( (data_length > UINT32_MAX) || (buffer->storage_size <= RL_BIPBUFFER_HEADER_SIZE)
+            || (data_length >= (buffer->storage_size - RL_BIPBUFFER_HEADER_SIZE)))
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    const size_t record = RL_BIPBUFFER_RECORD_SIZE (data_length);
+
+    // Head may never catch up with tail, one alignment unit stays free.
+    if (record >= buffer->storage_size) { return RL_ERROR_DATA_LENGTH; }
+
+    if (!buffer_lock (buffer, buffer->writelock, true)) { return RL_ERROR_CONCURRENCY; }
+
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+    size_t start = NO_RESERVATION;
+
+    if (head >= tail)
+    {
+        if ( (buffer->storage_size - head) >= record)
+        {
+            start = head;
+        }
+        else if (tail > record)
+        {
+            // Doesn't fit in the end, wrap to start.
+            start = 0;
+        }
+    }
+    else if ( (tail - head) > record)
+    {
+        start = head;
+    }
+
+    if (NO_RESERVATION == start)
+    {
+        if (!buffer_lock (buffer, buffer->writelock, false)) { err_code |= RL_ERROR_FATAL; }
+
+        err_code |= RL_ERROR_NO_MEM;
+    }
+    else
+    {
+        uint8_t * const p_record = (uint8_t *) buffer->storage + start;
+        const uint32_t length = (uint32_t) data_length;
+        memcpy (p_record, &length, sizeof (length));
+        buffer->reserved = start;
+        void ** p_data = (void **) data;
+        *p_data = p_record + RL_BIPBUFFER_HEADER_SIZE;
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_bipbuffer_commit (rl_bipbuffer_t * const buffer)
+{
+    if (NULL == buffer)                         { return RL_ERROR_NULL; }
+
+    if (NO_RESERVATION == buffer->reserved)     { return RL_ERROR_INTERNAL; }
+
+    const size_t start = buffer->reserved;
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    uint32_t length = 0;
+    memcpy (&length, (uint8_t *) buffer->storage + start, sizeof (length));
+    const size_t new_head = start + RL_BIPBUFFER_RECORD_SIZE (length);
+
+    if (start < head)
+    {
+        // Wrapped, valid data of previous lap ends at old head.
+        atomic_store_explicit (&buffer->watermark, head, memory_order_release);
+    }
+    else if (new_head > atomic_load_explicit (&buffer->watermark, memory_order_relaxed))
+    {
+        // Writing past watermark of previous lap, all of storage is valid again.
+        atomic_store_explicit (&buffer->watermark, buffer->storage_size,
+                               memory_order_release);
+    }
+    else
+    {
+        // Head stays below watermark, nothing to update.
+    }
+
+    buffer->reserved = NO_RESERVATION;
+    atomic_store_explicit (&buffer->head, new_head, memory_order_release);
+
+    if (!buffer_lock (buffer, buffer->writelock, false)) { return RL_ERROR_FATAL; }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_bipbuffer_queue (rl_bipbuffer_t * const buffer,
+                                const void * const data,
+                                const size_t data_length)
+{
+    void * p_record = NULL;
+
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    rl_status_t err_code = rl_bipbuffer_reserve (buffer, data_length, &p_record);
+
+    if (RL_SUCCESS == err_code)
+    {
+        memcpy (p_record, data, data_length);
+        err_code |= rl_bipbuffer_commit (buffer);
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Common implementation of peek and dequeue.
+ */
+static rl_status_t read_record (rl_bipbuffer_t * const buffer,
+                                void * const data,
+                                size_t * const data_length,
+                                const bool consume)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data || NULL == data_length) { return RL_ERROR_NULL; }
+
+    if (!buffer_lock (buffer, buffer->readlock, true))  { return RL_ERROR_CONCURRENCY; }
+
+    size_t head = 0;
+    const size_t tail = read_offset (buffer, &head);
+
+    if (head == tail)
+    {
+        err_code |= RL_ERROR_NO_DATA;
+    }
+    else
+    {
+        uint8_t * const p_record = (uint8_t *) buffer->storage + tail;
+        uint32_t length = 0;
+        memcpy (&length, p_record, sizeof (length));
+        void ** p_data = (void **) data;
+        *p_data = p_record + RL_BIPBUFFER_HEADER_SIZE;
+        *data_length = length;
+
+        if (consume)
+        {
+            atomic_store_explicit (&buffer->tail, tail + RL_BIPBUFFER_RECORD_SIZE (length),
+                                   memory_order_release);
+        }
+    }
+
+    if (!buffer_lock (buffer, buffer->readlock, false)) { err_code |= RL_ERROR_FATAL; }
+
+    return err_code;
+}
+
+rl_status_t rl_bipbuffer_peek (rl_bipbuffer_t * const buffer,
+                               void * const data,
+                               size_t * const data_length)
+{
+    return read_record (buffer, data, data_length, false);
+}
+
+rl_status_t rl_bipbuffer_dequeue (rl_bipbuffer_t * const buffer,
+                                  void * const data,
+                                  size_t * const data_length)
+{
+    return read_record (buffer, data, data_length, true);
+}
+
+bool rl_bipbuffer_empty (const rl_bipbuffer_t * const buffer)
+{
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    return head == tail;
+}
@@ -1,27 +1,333 @@
 #include "ruuvi_library.h"
 #include "ruuvi_library_ringbuffer.h"
+#include <stdatomic.h>
 #include <string.h>
 
+/*
+ * Statistics counters other than lock failures have a single writer, the producer or
+ * consumer holding its lock, so a plain load and store is enough and avoids a locked
+ * read-modify-write on every element.
+ */
+#if RL_RINGBUFFER_STATS_ENABLED
+#   define STAT_ADD(buffer, counter, n) \
+    atomic_store_explicit (&(buffer)->counter, (n) + \
+                           atomic_load_explicit (&(buffer)->counter, memory_order_relaxed), \
+                           memory_order_relaxed)
+#   define STAT_ADD_SHARED(buffer, counter, n) \
+    atomic_fetch_add_explicit (&(buffer)->counter, (n), memory_order_relaxed)
+#else
+#   define STAT_ADD(buffer, counter, n)
+#   define STAT_ADD_SHARED(buffer, counter, n)
+#endif
+
+/**
+ * @brief Number of elements from tail to head.
+ *
+ * Head and tail are free-running counters, masked only to index storage, so a tail
+ * which producer moved a whole buffer ahead never equals a consumer's stale copy.
+ * A stale tail may lag head by more than a buffer in overwrite mode, count is capped
+ * so that callers never index past storage.
+ */
+static inline size_t stored_count (const rl_ringbuffer_t * const buffer,
+                                   const size_t head, const size_t tail)
+{
+    const size_t stored = head - tail;
+    return (stored < buffer->index_mask) ? stored : buffer->index_mask;
+}
+
+/**
+ * @brief Acquire or release a buffer lock.
+ *
+ * Buffers without lock function are in single-producer, single-consumer mode
+ * and rely only on the ordering of head and tail updates.
+ */
+static inline bool buffer_lock (rl_ringbuffer_t * const buffer,
+                                volatile void * const flag, const bool set)
+{
+    const bool locked = (NULL == buffer->lock) || buffer->lock (flag, set);
+
+    if (!locked && set)
+    {
+        STAT_ADD_SHARED (buffer, stat_lock_failures, 1);
+    }
+
+    return locked;
+}
+
+/**
+ * @brief Record elements published by producer at new head.
+ *
+ * Peak is rechecked against a fresh tail only if cached tail suggests a new peak,
+ * as the cached copy can only overestimate the occupancy.
+ */
+static inline void record_queued (rl_ringbuffer_t * const buffer, const size_t head,
+                                  const size_t count)
+{
+#if RL_RINGBUFFER_STATS_ENABLED
+    STAT_ADD (buffer, stat_queued, count);
+    const size_t peak = atomic_load_explicit (&buffer->stat_peak, memory_order_relaxed);
+
+    if (stored_count (buffer, head, buffer->tail_cache) > peak)
+    {
+        const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+        const size_t stored = stored_count (buffer, head, tail);
+
+        if (stored > peak)
+        {
+            atomic_store_explicit (&buffer->stat_peak, stored, memory_order_relaxed);
+        }
+    }
+
+#else
+    (void) buffer;
+    (void) head;
+    (void) count;
+#endif
+}
+
+/**
+ * @brief Number of free slots seen by producer.
+ *
+ * Producer works from its cached copy of tail and reloads tail only if the copy
+ * doesn't show enough room, so consumer's cache line is not read on every call.
+ * Cached tail can only lag behind, which underestimates free room.
+ */
+static size_t producer_space (rl_ringbuffer_t * const buffer, const size_t head,
+                              const size_t needed)
+{
+    size_t space = buffer->index_mask - stored_count (buffer, head, buffer->tail_cache);
+
+    if (space < needed)
+    {
+        // Acquire pairs with consumer release, slot is free before it is overwritten.
+        buffer->tail_cache = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+        space = buffer->index_mask - stored_count (buffer, head, buffer->tail_cache);
+    }
+
+    return space;
+}
+
+/**
+ * @brief Number of stored elements seen by consumer.
+ *
+ * Consumer works from its cached copy of head and reloads head only if the copy
+ * doesn't show enough elements. In overwrite mode producer may move tail past the
+ * cached head, so head is always reloaded.
+ */
+static size_t consumer_stored (rl_ringbuffer_t * const buffer, const size_t tail,
+                               const size_t needed)
+{
+    size_t stored = stored_count (buffer, buffer->head_cache, tail);
+
+    if ( (stored < needed) || (RL_RINGBUFFER_POLICY_OVERWRITE == buffer->policy))
+    {
+        // Acquire pairs with producer release, data is visible before it is read.
+        buffer->head_cache = atomic_load_explicit (&buffer->head, memory_order_acquire);
+        stored = stored_count (buffer, buffer->head_cache, tail);
+    }
+
+    return stored;
+}
+
+/**
+ * @brief Make room for count new elements by dropping the oldest ones.
+ *
+ * Called by producer holding the write lock. In locked mode the read lock is taken
+ * to move tail, in lock-free mode tail is moved with compare-and-swap as the
+ * consumer may advance it at the same time.
+ */
+static rl_status_t drop_oldest (rl_ringbuffer_t * const buffer, const size_t count)
+{
+    rl_status_t err_code = RL_SUCCESS;
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+    size_t space = buffer->index_mask - stored_count (buffer, head, tail);
+
+    if (NULL == buffer->lock)
+    {
+        while (space < count)
+        {
+            const size_t drop = count - space;
+
+            if (atomic_compare_exchange_weak_explicit (&buffer->tail, &tail, tail + drop,
+                    memory_order_acq_rel, memory_order_acquire))
+            {
+                atomic_fetch_add_explicit (&buffer->dropped, drop, memory_order_relaxed);
+                tail += drop;
+                break;
+            }
+
+            // Consumer moved tail, recheck how much still has to go.
+            space = buffer->index_mask - stored_count (buffer, head, tail);
+        }
+    }
+    else if (!buffer_lock (buffer, buffer->readlock, true))
+    {
+        err_code |= RL_ERROR_CONCURRENCY;
+    }
+    else
+    {
+        tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+        space = buffer->index_mask - stored_count (buffer, head, tail);
+
+        if (space < count)
+        {
+            const size_t drop = count - space;
+            tail += drop;
+            atomic_store_explicit (&buffer->tail, tail, memory_order_release);
+            atomic_fetch_add_explicit (&buffer->dropped, drop, memory_order_relaxed);
+        }
+
+        if (!buffer->lock (buffer->readlock, false)) { err_code |= RL_ERROR_FATAL; }
+    }
+
+    buffer->tail_cache = tail;
+    return err_code;
+}
+
+/**
+ * @brief Move tail past count consumed elements.
+ *
+ * @param[in,out] p_tail In: tail the consumer read from. Out: current tail if the
+ *                       producer dropped elements meanwhile.
+ * @return false if producer dropped the elements first, consumer has to read again.
+ *         Tail is not masked, so a producer which dropped exactly a buffer's worth
+ *         of elements meanwhile still fails the compare.
+ */
+static inline bool tail_advance (rl_ringbuffer_t * const buffer, size_t * const p_tail,
+                                 const size_t count)
+{
+    const size_t next = *p_tail + count;
+
+    if ( (NULL == buffer->lock) && (RL_RINGBUFFER_POLICY_OVERWRITE == buffer->policy))
+    {
+        return atomic_compare_exchange_strong_explicit (&buffer->tail, p_tail, next,
+                memory_order_acq_rel, memory_order_acquire);
+    }
+
+    // Release hands the slots back to producer.
+    atomic_store_explicit (&buffer->tail, next, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Wake sleeping consumers if smallest count they wait for is stored.
+ *
+ * Called by producer after publishing new head. The fence pairs with the fence in
+ * @ref rl_ringbuffer_wait: either the consumer sees the new head before sleeping or
+ * the producer sees its threshold, so a wakeup is never lost. Threshold is cleared
+ * before the sequence is bumped, and every woken consumer publishes its own count
+ * again before sleeping.
+ */
+static void wake_consumers (rl_ringbuffer_t * const buffer, const size_t head)
+{
+    if (NULL != buffer->waiter)
+    {
+        atomic_thread_fence (memory_order_seq_cst);
+        const size_t threshold = atomic_load_explicit (&buffer->wake_threshold,
+                                 memory_order_relaxed);
+
+        if (0 < threshold)
+        {
+            const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+
+            if ( (stored_count (buffer, head, tail) >= threshold)
+                    && (0 < atomic_exchange_explicit (&buffer->wake_threshold, 0,
+                            memory_order_relaxed)))
+            {
+                atomic_fetch_add_explicit (&buffer->wake_seq, 1, memory_order_release);
+                buffer->waiter->notify (buffer->waiter->context, &buffer->wake_seq);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lower wake threshold to count unless a smaller one is already set.
+ */
+static void wake_threshold_publish (rl_ringbuffer_t * const buffer, const size_t count)
+{
+    size_t threshold = atomic_load_explicit (&buffer->wake_threshold, memory_order_relaxed);
+
+    while ( ( (0 == threshold) || (count < threshold))
+            && !atomic_compare_exchange_weak_explicit (&buffer->wake_threshold, &threshold,
+                    count, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+rl_status_t rl_ringbuffer_reserve (rl_ringbuffer_t * const buffer,
+                                   void * const data)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    if (!buffer_lock (buffer, buffer->writelock, true)) { return RL_ERROR_CONCURRENCY; }
+
+    // Only producer writes head, relaxed load is enough.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+
+    // Fullness is checked under the lock so that concurrent producers cannot
+    // both claim the last free slot.
+    if (0 == producer_space (buffer, head, 1))
+    {
+        err_code |= (RL_RINGBUFFER_POLICY_OVERWRITE == buffer->policy) ?
+                    drop_oldest (buffer, 1) : RL_ERROR_NO_MEM;
+    }
+
+    if (RL_ERROR_NO_MEM == err_code)
+    {
+        STAT_ADD (buffer, stat_rejected, 1);
+    }
+
+    if (RL_SUCCESS != err_code)
+    {
+        if (!buffer_lock (buffer, buffer->writelock, false)) { err_code |= RL_ERROR_FATAL; }
+    }
+    else
+    {
+        void ** p_data = (void **) data;
+        *p_data = buffer->storage + ( (head & buffer->index_mask) * buffer->block_size);
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_commit (rl_ringbuffer_t * const buffer)
+{
+    if (NULL == buffer)                         { return RL_ERROR_NULL; }
+
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed) + 1;
+    // Release publishes the slot contents before consumer can see new head.
+    atomic_store_explicit (&buffer->head, head, memory_order_release);
+    record_queued (buffer, head, 1);
+
+    if (!buffer_lock (buffer, buffer->writelock, false)) { return RL_ERROR_FATAL; }
+
+    wake_consumers (buffer, head);
+    return RL_SUCCESS;
+}
 
 rl_status_t rl_ringbuffer_queue (rl_ringbuffer_t * const buffer,
                                  const void * const data,
                                  const size_t data_length)
 {
-    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+    void * p_slot = NULL;
 
-    if (rl_ringbuffer_full (buffer))  { return RL_ERROR_NO_MEM; }
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
 
     if (buffer->block_size < data_length)       { return RL_ERROR_DATA_LENGTH; }
 
-    if (!buffer->lock (buffer->writelock, true)) { return RL_ERROR_CONCURRENCY; }
-
-    memcpy ( (buffer->storage) + (buffer->head * buffer->block_size),
-             data, data_length);
-    buffer->head = ( (buffer->head + 1) & buffer->index_mask);
+    rl_status_t err_code = rl_ringbuffer_reserve (buffer, &p_slot);
 
-    if (!buffer->lock (buffer->writelock, false)) { return RL_ERROR_FATAL; }
+    if (RL_SUCCESS == err_code)
+    {
+        memcpy (p_slot, data, data_length);
+        err_code |= rl_ringbuffer_commit (buffer);
+    }
 
-    return RL_SUCCESS;
+    return err_code;
 }
 
 rl_status_t rl_ringbuffer_dequeue (rl_ringbuffer_t * const buffer,
@@ -33,21 +339,36 @@ rl_status_t rl_ringbuffer_dequeue (rl_ringbuffer_t * const buffer,
     {
         err_code |= RL_ERROR_NULL;
     }
-    else if (rl_ringbuffer_empty (buffer))
+    else if (!buffer_lock (buffer, buffer->readlock, true))
     {
-        err_code |= RL_ERROR_NO_DATA;
+        err_code |= RL_ERROR_CONCURRENCY;
     }
-    else if (!buffer->lock (buffer->readlock, true))
+    else if (0 == consumer_stored (buffer, atomic_load_explicit (&buffer->tail,
+                                   memory_order_relaxed), 1))
     {
-        err_code |= RL_ERROR_CONCURRENCY;
+        // Emptiness is checked under the lock so that concurrent consumers cannot
+        // both take the last element.
+        if (!buffer_lock (buffer, buffer->readlock, false))
+        {
+            err_code |= RL_ERROR_FATAL;
+        }
+
+        err_code |= RL_ERROR_NO_DATA;
     }
     else
     {
+        size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
         void ** p_data = (void **) data;
-        *p_data = buffer->storage + (buffer->tail * buffer->block_size);
-        buffer->tail = ( (buffer->tail + 1) & buffer->index_mask);
 
-        if (!buffer->lock (buffer->readlock, false))
+        // Producer drops only from a full buffer, there is data after a lost race.
+        do
+        {
+            *p_data = buffer->storage + ( (tail & buffer->index_mask) * buffer->block_size);
+        } while (!tail_advance (buffer, &tail, 1));
+
+        STAT_ADD (buffer, stat_dequeued, 1);
+
+        if (!buffer_lock (buffer, buffer->readlock, false))
         {
             err_code |= RL_ERROR_FATAL;
         }
@@ -56,34 +377,390 @@ rl_status_t rl_ringbuffer_dequeue (rl_ringbuffer_t * const buffer,
     return err_code;
 }
 
+/**
+ * @brief Copy count elements into storage starting from counter position, wrapping around.
+ */
+static void storage_write (rl_ringbuffer_t * const buffer, const size_t position,
+                           const uint8_t * const data, const size_t count)
+{
+    const size_t index = position & buffer->index_mask;
+    const size_t first = (buffer->index_mask + 1) - index;
+    const size_t first_count = (count < first) ? count : first;
+    memcpy ( (uint8_t *) buffer->storage + (index * buffer->block_size), data,
+             first_count * buffer->block_size);
+
+    if (count > first_count)
+    {
+        memcpy (buffer->storage, data + (first_count * buffer->block_size),
+                (count - first_count) * buffer->block_size);
+    }
+}
+
+/**
+ * @brief Copy count elements out of storage starting from counter position, wrapping around.
+ */
+static void storage_read (const rl_ringbuffer_t * const buffer, const size_t position,
+                          uint8_t * const data, const size_t count)
+{
+    const size_t index = position & buffer->index_mask;
+    const size_t first = (buffer->index_mask + 1) - index;
+    const size_t first_count = (count < first) ? count : first;
+    memcpy (data, (const uint8_t *) buffer->storage + (index * buffer->block_size),
+            first_count * buffer->block_size);
+
+    if (count > first_count)
+    {
+        memcpy (data + (first_count * buffer->block_size), buffer->storage,
+                (count - first_count) * buffer->block_size);
+    }
+}
+
+rl_status_t rl_ringbuffer_queue_n (rl_ringbuffer_t * const buffer,
+                                   const void * const data,
+                                   const size_t count)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    if (buffer->index_mask < count)             { return RL_ERROR_DATA_LENGTH; }
+
+    if (!buffer_lock (buffer, buffer->writelock, true)) { return RL_ERROR_CONCURRENCY; }
+
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+
+    if (producer_space (buffer, head, count) < count)
+    {
+        err_code |= (RL_RINGBUFFER_POLICY_OVERWRITE == buffer->policy) ?
+                    drop_oldest (buffer, count) : RL_ERROR_NO_MEM;
+    }
+
+    if (RL_SUCCESS == err_code)
+    {
+        storage_write (buffer, head, data, count);
+        atomic_store_explicit (&buffer->head, head + count, memory_order_release);
+        record_queued (buffer, head + count, count);
+    }
+    else if (RL_ERROR_NO_MEM == err_code)
+    {
+        STAT_ADD (buffer, stat_rejected, count);
+    }
+
+    if (!buffer_lock (buffer, buffer->writelock, false)) { err_code |= RL_ERROR_FATAL; }
+
+    if (RL_SUCCESS == err_code)
+    {
+        wake_consumers (buffer, head + count);
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_dequeue_n (rl_ringbuffer_t * const buffer,
+                                     void * const data,
+                                     size_t * const count)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data || NULL == count) { return RL_ERROR_NULL; }
+
+    if (!buffer_lock (buffer, buffer->readlock, true))   { return RL_ERROR_CONCURRENCY; }
+
+    const size_t requested = *count;
+    size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    size_t stored = 0;
+
+    do
+    {
+        // Head is reloaded after a lost race, tail may have moved past the old head.
+        stored = consumer_stored (buffer, tail, requested);
+        *count = (requested < stored) ? requested : stored;
+
+        if (0 < stored)
+        {
+            storage_read (buffer, tail, data, *count);
+        }
+    } while ( (0 < stored) && !tail_advance (buffer, &tail, *count));
+
+    if (0 == stored)
+    {
+        err_code |= RL_ERROR_NO_DATA;
+    }
+    else
+    {
+        STAT_ADD (buffer, stat_dequeued, *count);
+    }
+
+    if (!buffer_lock (buffer, buffer->readlock, false))  { err_code |= RL_ERROR_FATAL; }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_wait (rl_ringbuffer_t * const buffer,
+                                const size_t count,
+                                const uint32_t timeout_ms)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == buffer->waiter || NULL == buffer->waiter->now_ms)
+    {
+        return RL_ERROR_NULL;
+    }
+
+    if ( (0 == count) || (buffer->index_mask < count)) { return RL_ERROR_DATA_LENGTH; }
+
+    const uint32_t start = buffer->waiter->now_ms (buffer->waiter->context);
+
+    while (RL_SUCCESS == err_code)
+    {
+        // Sequence is read before threshold is published: if producer clears the
+        // threshold after this, it also bumps the sequence and wait returns at once.
+        const uint32_t seq = atomic_load_explicit (&buffer->wake_seq, memory_order_acquire);
+        wake_threshold_publish (buffer, count);
+        // Pairs with the fence in wake_consumers.
+        atomic_thread_fence (memory_order_seq_cst);
+        // Tail first, a tail loaded after head could already be past it.
+        const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+        const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+
+        if (stored_count (buffer, head, tail) >= count)
+        {
+            break;
+        }
+
+        // Unsigned difference is correct across clock wraparound.
+        const uint32_t elapsed = buffer->waiter->now_ms (buffer->waiter->context) - start;
+
+        if (elapsed >= timeout_ms)
+        {
+            err_code |= RL_ERROR_NO_DATA;
+        }
+        else
+        {
+            // Timeout of hook is checked against clock on next round.
+            err_code |= buffer->waiter->wait (buffer->waiter->context, &buffer->wake_seq,
+                                              seq, timeout_ms - elapsed) & ~RL_ERROR_NO_DATA;
+        }
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_dequeue_wait (rl_ringbuffer_t * const buffer,
+                                        void * const data,
+                                        size_t * const count,
+                                        const uint32_t timeout_ms)
+{
+    if (NULL == buffer || NULL == data || NULL == count) { return RL_ERROR_NULL; }
+
+    const size_t threshold = (buffer->index_mask < *count) ? buffer->index_mask : *count;
+    rl_status_t err_code = rl_ringbuffer_wait (buffer, threshold, timeout_ms);
+
+    // Timeout still hands out whatever was stored meanwhile.
+    if ( (RL_SUCCESS == err_code) || (RL_ERROR_NO_DATA == err_code))
+    {
+        err_code = rl_ringbuffer_dequeue_n (buffer, data, count);
+    }
+    else
+    {
+        *count = 0;
+    }
+
+    return err_code;
+}
+
 rl_status_t rl_ringbuffer_peek (rl_ringbuffer_t * const
                                 buffer,
                                 const void * data, const size_t index)
 {
+    rl_status_t err_code = RL_SUCCESS;
+
     if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
 
-    if ( ( (buffer->tail + index) & buffer->index_mask) == buffer->head)
+    if (!buffer_lock (buffer, buffer->readlock, true))  {return RL_ERROR_CONCURRENCY; }
+
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+
+    if (index >= consumer_stored (buffer, tail, index + 1))
+    {
+        err_code |= RL_ERROR_NO_DATA;
+    }
+    else
+    {
+        void ** p_data = (void **) data;
+        *p_data = buffer->storage + ( ( (tail + index) & buffer->index_mask) *
+                                      buffer->block_size);
+    }
+
+    if (!buffer_lock (buffer, buffer->readlock, false)) { err_code |= RL_ERROR_FATAL; }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_peek_range (rl_ringbuffer_t * const buffer,
+                                      const size_t index, const size_t count,
+                                      rl_ringbuffer_span_t spans[2])
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == spans)        { return RL_ERROR_NULL; }
+
+    if (!buffer_lock (buffer, buffer->readlock, true))  { return RL_ERROR_CONCURRENCY; }
+
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    const size_t stored = consumer_stored (buffer, tail, index + count);
+
+    if ( (index > stored) || (count > (stored - index)))
+    {
+        err_code |= RL_ERROR_NO_DATA;
+    }
+    else
+    {
+        const size_t start = (tail + index) & buffer->index_mask;
+        const size_t first = (buffer->index_mask + 1) - start;
+        spans[0].count = (count < first) ? count : first;
+        spans[1].count = count - spans[0].count;
+        spans[0].data = (0 < spans[0].count) ?
+                        (uint8_t *) buffer->storage + (start * buffer->block_size) : NULL;
+        spans[1].data = (0 < spans[1].count) ? buffer->storage : NULL;
+    }
+
+    if (!buffer_lock (buffer, buffer->readlock, false)) { err_code |= RL_ERROR_FATAL; }
+
+    return err_code;
+}
+
+/**
+ * @brief Timestamp at the start of element at logical index from tail.
+ */
+static inline uint32_t element_time (const rl_ringbuffer_t * const buffer,
+                                     const size_t tail, const size_t index)
+{
+    uint32_t time;
+    // Elements such as rl_data_t may be packed, copy instead of dereferencing.
+    memcpy (&time, (const uint8_t *) buffer->storage
+            + ( ( (tail + index) & buffer->index_mask) * buffer->block_size), sizeof (time));
+    return time;
+}
+
+rl_status_t rl_ringbuffer_find_time (rl_ringbuffer_t * const buffer,
+                                     const uint32_t time,
+                                     size_t * const index)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == index)        { return RL_ERROR_NULL; }
+
+    if (sizeof (uint32_t) > buffer->block_size) { return RL_ERROR_DATA_LENGTH; }
+
+    if (!buffer_lock (buffer, buffer->readlock, true))  { return RL_ERROR_CONCURRENCY; }
+
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    // Asking for a full buffer refreshes cached head, search covers latest data.
+    const size_t stored = consumer_stored (buffer, tail, buffer->index_mask);
+    size_t low = 0;
+    size_t high = stored;
+
+    if (0 < stored)
+    {
+        // Offsets from oldest timestamp grow monotonically even across counter wrap.
+        const uint32_t oldest = element_time (buffer, tail, 0);
+        const uint32_t target = ( (int32_t) (time - oldest) > 0) ? (time - oldest) : 0;
+
+        while (low < high)
+        {
+            const size_t mid = low + ( (high - low) / 2);
+
+            if ( (uint32_t) (element_time (buffer, tail, mid) - oldest) < target)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+    }
+
+    *index = low;
+
+    if (low >= stored)
     {
-        return RL_ERROR_NO_DATA;
+        err_code |= RL_ERROR_NO_DATA;
     }
 
-    if (!buffer->lock (buffer->readlock, true))  {return RL_ERROR_CONCURRENCY; }
+    if (!buffer_lock (buffer, buffer->readlock, false)) { err_code |= RL_ERROR_FATAL; }
 
-    void ** p_data = (void **) data;
-    *p_data = buffer->storage + ( ( (buffer->tail + index) & buffer->index_mask) *
-                                  buffer->block_size);
+    return err_code;
+}
 
-    if (!buffer->lock (buffer->readlock, false)) {return RL_ERROR_FATAL; }
+#if RL_RINGBUFFER_STATS_ENABLED
+rl_status_t rl_ringbuffer_stats_get (const rl_ringbuffer_t * const buffer,
+                                     rl_ringbuffer_stats_t * const stats)
+{
+    if (NULL == buffer || NULL == stats)        { return RL_ERROR_NULL; }
 
+    stats->queued = atomic_load_explicit (&buffer->stat_queued, memory_order_relaxed);
+    stats->dequeued = atomic_load_explicit (&buffer->stat_dequeued, memory_order_relaxed);
+    stats->peak = atomic_load_explicit (&buffer->stat_peak, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit (&buffer->stat_rejected, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit (&buffer->dropped, memory_order_relaxed);
+    stats->lock_failures = atomic_load_explicit (&buffer->stat_lock_failures,
+                           memory_order_relaxed);
     return RL_SUCCESS;
 }
 
+void rl_ringbuffer_stats_reset (rl_ringbuffer_t * const buffer)
+{
+    if (NULL != buffer)
+    {
+        atomic_store_explicit (&buffer->stat_queued, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->stat_dequeued, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->stat_peak, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->stat_rejected, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->stat_lock_failures, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->dropped, 0, memory_order_relaxed);
+    }
+}
+#endif
+
+void rl_ringbuffer_reset (rl_ringbuffer_t * const buffer)
+{
+    if (NULL != buffer)
+    {
+        buffer->tail_cache = 0;
+        buffer->head_cache = 0;
+#if RL_RINGBUFFER_STATS_ENABLED
+        rl_ringbuffer_stats_reset (buffer);
+#endif
+        atomic_store_explicit (&buffer->dropped, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->wake_threshold, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->head, 0, memory_order_relaxed);
+        atomic_store_explicit (&buffer->tail, 0, memory_order_release);
+    }
+}
+
+size_t rl_ringbuffer_count (const rl_ringbuffer_t * const buffer)
+{
+    // Tail first, a tail loaded after head could already be past it.
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    // Acquire pairs with producer release, counted data is visible.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    return stored_count (buffer, head, tail);
+}
+
 bool rl_ringbuffer_full (const rl_ringbuffer_t * const buffer)
 {
-    return ( (buffer->head - buffer->tail) & buffer->index_mask) == buffer->index_mask;
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    // Acquire pairs with consumer release, slot is free before it is overwritten.
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+    return stored_count (buffer, head, tail) == buffer->index_mask;
 }
 
 bool rl_ringbuffer_empty (const rl_ringbuffer_t * const buffer)
 {
-    return buffer->head == buffer->tail;
+    // Acquire pairs with producer release, data is visible before it is read.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    return head == tail;
 }
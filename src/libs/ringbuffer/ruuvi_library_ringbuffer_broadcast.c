@@ -0,0 +1,208 @@
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer_broadcast.h"
+#include <stdatomic.h>
+#include <string.h>
+
+/**
+ * @brief Mask of head and cursor counters.
+ *
+ * Counters run over twice the number of slots, so a full buffer is distinguished
+ * from an empty one and no counter value collides with the detached marker.
+ */
+static inline size_t counter_mask (const rl_ringbuffer_broadcast_t * const buffer)
+{
+    return (buffer->index_mask << 1U) | 1U;
+}
+
+/**
+ * @brief Number of elements between cursor and head.
+ */
+static inline size_t distance (const rl_ringbuffer_broadcast_t * const buffer,
+                               const size_t head, const size_t cursor)
+{
+    return (head - cursor) & counter_mask (buffer);
+}
+
+/**
+ * @brief Find cursor of the slowest attached reader.
+ *
+ * The fence pairs with the fence in @ref rl_ringbuffer_broadcast_attach: either the
+ * producer sees the new cursor or the attaching reader sees the latest head.
+ * Cursors are compared by distance from head to stay correct on counter wrap.
+ *
+ * @return Slowest cursor, head if no reader is attached.
+ */
+static size_t slowest_cursor (const rl_ringbuffer_broadcast_t * const buffer,
+                              const size_t head)
+{
+    size_t slowest = head;
+    atomic_thread_fence (memory_order_seq_cst);
+
+    for (size_t ii = 0; ii < buffer->reader_count; ii++)
+    {
+        // Acquire pairs with reader release, slot is read before it is overwritten.
+        const size_t cursor = atomic_load_explicit (&buffer->cursors[ii],
+                              memory_order_acquire);
+
+        if ( (RL_RINGBUFFER_BROADCAST_DETACHED != cursor)
+                && (distance (buffer, head, cursor) > distance (buffer, head, slowest)))
+        {
+            slowest = cursor;
+        }
+    }
+
+    return slowest;
+}
+
+rl_status_t rl_ringbuffer_broadcast_init (rl_ringbuffer_broadcast_t * const buffer)
+{
+    if (NULL == buffer || NULL == buffer->storage || NULL == buffer->cursors)
+    {
+        return RL_ERROR_NULL;
+    }
+
+    for (size_t ii = 0; ii < buffer->reader_count; ii++)
+    {
+        atomic_store_explicit (&buffer->cursors[ii], 0, memory_order_relaxed);
+    }
+
+    buffer->tail_cache = 0;
+    atomic_store_explicit (&buffer->head, 0, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_broadcast_queue (rl_ringbuffer_broadcast_t * const buffer,
+        const void * const data,
+        const size_t data_length)
+{
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    if (buffer->block_size < data_length)       { return RL_ERROR_DATA_LENGTH; }
+
+    // Only producer writes head, relaxed load is enough.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+
+    // Cursors are polled only when cached slowest cursor says the buffer is full.
+    if (distance (buffer, head, buffer->tail_cache) > buffer->index_mask)
+    {
+        buffer->tail_cache = slowest_cursor (buffer, head);
+
+        if (distance (buffer, head, buffer->tail_cache) > buffer->index_mask)
+        {
+            return RL_ERROR_NO_MEM;
+        }
+    }
+
+    const size_t slot = head & buffer->index_mask;
+    memcpy ( (uint8_t *) buffer->storage + (slot * buffer->block_size), data, data_length);
+    // Release publishes the slot contents before readers can see new head.
+    atomic_store_explicit (&buffer->head, (head + 1) & counter_mask (buffer),
+                           memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_broadcast_peek (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader,
+        rl_ringbuffer_span_t spans[2])
+{
+    if (NULL == buffer || NULL == spans)        { return RL_ERROR_NULL; }
+
+    if (buffer->reader_count <= reader)         { return RL_ERROR_DATA_LENGTH; }
+
+    // Only this reader writes its cursor.
+    const size_t cursor = atomic_load_explicit (&buffer->cursors[reader],
+                          memory_order_relaxed);
+    // Acquire pairs with producer release, data is visible before it is read.
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+
+    if ( (RL_RINGBUFFER_BROADCAST_DETACHED == cursor) || (head == cursor))
+    {
+        return RL_ERROR_NO_DATA;
+    }
+
+    const size_t count = distance (buffer, head, cursor);
+    const size_t start = cursor & buffer->index_mask;
+    const size_t first = (buffer->index_mask + 1) - start;
+    spans[0].count = (count < first) ? count : first;
+    spans[1].count = count - spans[0].count;
+    spans[0].data = (uint8_t *) buffer->storage + (start * buffer->block_size);
+    spans[1].data = (0 < spans[1].count) ? buffer->storage : NULL;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_broadcast_release (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader,
+        const size_t count)
+{
+    if (NULL == buffer)                         { return RL_ERROR_NULL; }
+
+    if (buffer->reader_count <= reader)         { return RL_ERROR_DATA_LENGTH; }
+
+    const size_t cursor = atomic_load_explicit (&buffer->cursors[reader],
+                          memory_order_relaxed);
+
+    if (RL_RINGBUFFER_BROADCAST_DETACHED == cursor)
+    {
+        return RL_ERROR_NO_DATA;
+    }
+
+    if (distance (buffer, atomic_load_explicit (&buffer->head, memory_order_relaxed),
+                  cursor) < count)
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    // Release hands the slots back to producer after they have been read.
+    atomic_store_explicit (&buffer->cursors[reader],
+                           (cursor + count) & counter_mask (buffer), memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_broadcast_attach (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader)
+{
+    if (NULL == buffer)                         { return RL_ERROR_NULL; }
+
+    if (buffer->reader_count <= reader)         { return RL_ERROR_DATA_LENGTH; }
+
+    // Claim an old position first so that producer which sees the cursor is held back,
+    // then move to the head producer had published when it could have missed it.
+    size_t head = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    atomic_store_explicit (&buffer->cursors[reader], head, memory_order_relaxed);
+    atomic_thread_fence (memory_order_seq_cst);
+    head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    atomic_store_explicit (&buffer->cursors[reader], head, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_broadcast_detach (rl_ringbuffer_broadcast_t * const buffer,
+        const size_t reader)
+{
+    if (NULL == buffer)                         { return RL_ERROR_NULL; }
+
+    if (buffer->reader_count <= reader)         { return RL_ERROR_DATA_LENGTH; }
+
+    atomic_store_explicit (&buffer->cursors[reader], RL_RINGBUFFER_BROADCAST_DETACHED,
+                           memory_order_release);
+    return RL_SUCCESS;
+}
+
+size_t rl_ringbuffer_broadcast_count (const rl_ringbuffer_broadcast_t * const buffer,
+                                      const size_t reader)
+{
+    size_t count = 0;
+
+    if ( (NULL != buffer) && (buffer->reader_count > reader))
+    {
+        const size_t cursor = atomic_load_explicit (&buffer->cursors[reader],
+                              memory_order_relaxed);
+        const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+
+        if (RL_RINGBUFFER_BROADCAST_DETACHED != cursor)
+        {
+            count = distance (buffer, head, cursor);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,252 @@
+#ifndef _POSIX_C_SOURCE
+#   define _POSIX_C_SOURCE 200809L
+#endif
+#include "ruuvi_library_ringbuffer_file.h"
+#if RL_RINGBUFFER_FILE_ENABLED
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include <fcntl.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Start of ringbuffer file, followed by rl_ringbuffer_t and storage.
+ */
+typedef struct
+{
+    uint32_t magic;        //!< RL_RINGBUFFER_FILE_MAGIC once file is initialized.
+    uint32_t version;      //!< RL_RINGBUFFER_FILE_VERSION.
+    uint64_t layout_size;  //!< sizeof (rl_ringbuffer_t) of the build which created file.
+    uint64_t block_size;   //!< Block size of elements.
+    uint64_t storage_size; //!< Size of storage in bytes.
+} file_header_t;
+
+static inline size_t align_up (const size_t offset, const size_t alignment)
+{
+    return ( (offset + alignment - 1U) / alignment) * alignment;
+}
+
+static inline size_t ring_offset (void)
+{
+    return align_up (sizeof (file_header_t), alignof (rl_ringbuffer_t));
+}
+
+/**
+ * @brief Storage starts on its own page so that it can be synced separately.
+ */
+static inline size_t storage_offset (void)
+{
+    return align_up (ring_offset() + sizeof (rl_ringbuffer_t),
+                     (size_t) sysconf (_SC_PAGESIZE));
+}
+
+/**
+ * @brief Check that elements fill storage exactly and mapping size doesn't overflow.
+ */
+static bool geometry_is_valid (const rl_ringbuffer_t * const config)
+{
+    const size_t elements = config->index_mask + 1U;
+    // Zero elements means index mask wrapped around.
+    return (0U != elements) && (0U == (elements & config->index_mask))
+           && (0U != config->block_size)
+           && (config->block_size <= (SIZE_MAX / elements))
+           && ( (elements * config->block_size) == config->storage_size)
+           && (config->storage_size <= (SIZE_MAX - storage_offset()));
+}
+
+/**
+ * @brief Check that header of existing file matches configuration.
+ */
+static bool header_matches (const file_header_t * const header,
+                            const rl_ringbuffer_t * const config)
+{
+    return (RL_RINGBUFFER_FILE_MAGIC == header->magic)
+           && (RL_RINGBUFFER_FILE_VERSION == header->version)
+           && (sizeof (rl_ringbuffer_t) == header->layout_size)
+           && (config->block_size == header->block_size)
+           && (config->storage_size == header->storage_size);
+}
+
+/**
+ * @brief Check that file creation was interrupted before magic was written.
+ *
+ * Creation fills the other fields of a zeroed header before magic, so each of them
+ * is still zero or already matches configuration. Anything else is a foreign file.
+ */
+static bool header_is_unfinished (const file_header_t * const header,
+                                  const rl_ringbuffer_t * const config)
+{
+    return (0U == header->magic)
+           && ( (0U == header->version) || (RL_RINGBUFFER_FILE_VERSION == header->version))
+           && ( (0U == header->layout_size)
+                || (sizeof (rl_ringbuffer_t) == header->layout_size))
+           && ( (0U == header->block_size) || (config->block_size == header->block_size))
+           && ( (0U == header->storage_size)
+                || (config->storage_size == header->storage_size));
+}
+
+static void file_unmap (rl_ringbuffer_file_t * const file)
+{
+    munmap (file->mapping, file->mapping_size);
+    close (file->fd);
+    file->buffer = NULL;
+    file->mapping = NULL;
+    file->mapping_size = 0;
+    file->fd = -1;
+}
+
+rl_status_t rl_ringbuffer_file_open (rl_ringbuffer_file_t * const file,
+                                     const char * const path,
+                                     const rl_ringbuffer_t * const config)
+{
+    struct stat file_stat;
+
+    if (NULL == file || NULL == path || NULL == config) { return RL_ERROR_NULL; }
+
+    if (!geometry_is_valid (config))            { return RL_ERROR_DATA_LENGTH; }
+
+    file->buffer = NULL;
+    file->mapping_size = storage_offset() + config->storage_size;
+    file->fd = open (path, O_RDWR | O_CREAT, 0644);
+
+    if (0 > file->fd)                           { return RL_ERROR_NO_MEM; }
+
+    if (0 != fstat (file->fd, &file_stat))
+    {
+        close (file->fd);
+        return RL_ERROR_NO_MEM;
+    }
+
+    bool fresh = (0 == file_stat.st_size);
+
+    if (!fresh && ( (off_t) file->mapping_size != file_stat.st_size))
+    {
+        close (file->fd);
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    if (fresh && (0 != ftruncate (file->fd, (off_t) file->mapping_size)))
+    {
+        close (file->fd);
+        return RL_ERROR_NO_MEM;
+    }
+
+    file->mapping = mmap (NULL, file->mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          file->fd, 0);
+
+    if (MAP_FAILED == file->mapping)
+    {
+        close (file->fd);
+        return RL_ERROR_NO_MEM;
+    }
+
+    file_header_t * const header = (file_header_t *) file->mapping;
+    rl_ringbuffer_t * const p_ring = (rl_ringbuffer_t *) ( (uint8_t *) file->mapping
+                                     + ring_offset());
+    size_t head = 0;
+    size_t tail = 0;
+    // Magic is written last, a file whose creation was interrupted is initialized again.
+    fresh = fresh || header_is_unfinished (header, config);
+
+    if (!fresh)
+    {
+        if (!header_matches (header, config))
+        {
+            file_unmap (file);
+            return RL_ERROR_DATA_LENGTH;
+        }
+
+        head = atomic_load_explicit (&p_ring->head, memory_order_acquire);
+        tail = atomic_load_explicit (&p_ring->tail, memory_order_acquire);
+
+        if ( (head - tail) > config->index_mask)
+        {
+            file_unmap (file);
+            return RL_ERROR_INTERNAL;
+        }
+    }
+
+    // Pointers and hooks belong to this process, rebuild the struct around the indices.
+    const rl_ringbuffer_t ring =
+    {
+        .head = head,
+        .tail_cache = tail,
+        .tail = tail,
+        .head_cache = head,
+        .block_size = config->block_size,
+        .storage_size = config->storage_size,
+        .index_mask = config->index_mask,
+        .storage = (uint8_t *) file->mapping + storage_offset(),
+        .lock = config->lock,
+        .writelock = config->writelock,
+        .readlock = config->readlock,
+        .policy = config->policy,
+        .waiter = config->waiter
+    };
+    memcpy (p_ring, &ring, sizeof (ring));
+
+    if (fresh)
+    {
+        header->version = RL_RINGBUFFER_FILE_VERSION;
+        header->layout_size = sizeof (rl_ringbuffer_t);
+        header->block_size = config->block_size;
+        header->storage_size = config->storage_size;
+        atomic_thread_fence (memory_order_release);
+        header->magic = RL_RINGBUFFER_FILE_MAGIC;
+    }
+
+    file->buffer = p_ring;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_file_sync (const rl_ringbuffer_file_t * const file)
+{
+    if (NULL == file || NULL == file->buffer)   { return RL_ERROR_NULL; }
+
+    const size_t offset = storage_offset();
+    rl_status_t err_code = RL_SUCCESS;
+
+    // Storage reaches disk before indices which point to it.
+    if (0 != msync ( (uint8_t *) file->mapping + offset, file->mapping_size - offset,
+                     MS_SYNC))
+    {
+        err_code |= RL_ERROR_INTERNAL;
+    }
+
+    if (0 != msync (file->mapping, offset, MS_SYNC))
+    {
+        err_code |= RL_ERROR_INTERNAL;
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_file_close (rl_ringbuffer_file_t * const file)
+{
+    if (NULL == file || NULL == file->buffer)   { return RL_ERROR_NULL; }
+
+    rl_status_t err_code = rl_ringbuffer_file_sync (file);
+
+    if (0 != munmap (file->mapping, file->mapping_size))
+    {
+        err_code |= RL_ERROR_INTERNAL;
+    }
+
+    if (0 != close (file->fd))
+    {
+        err_code |= RL_ERROR_INTERNAL;
+    }
+
+    file->buffer = NULL;
+    file->mapping = NULL;
+    file->mapping_size = 0;
+    file->fd = -1;
+    return err_code;
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer_mpmc.h"
+#include <stdatomic.h>
+#include <string.h>
+
+rl_status_t rl_ringbuffer_mpmc_init (rl_ringbuffer_mpmc_t * const buffer)
+{
+    if (NULL == buffer || NULL == buffer->storage || NULL == buffer->sequence)
+    {
+        return RL_ERROR_NULL;
+    }
+
+    // Slot i is free for producer which claims position i.
+    for (size_t ii = 0; ii <= buffer->index_mask; ii++)
+    {
+        atomic_store_explicit (&buffer->sequence[ii], ii, memory_order_relaxed);
+    }
+
+    atomic_store_explicit (&buffer->head, 0, memory_order_relaxed);
+    atomic_store_explicit (&buffer->tail, 0, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_mpmc_queue (rl_ringbuffer_mpmc_t * const buffer,
+                                      const void * const data,
+                                      const size_t data_length)
+{
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    if (buffer->block_size < data_length)       { return RL_ERROR_DATA_LENGTH; }
+
+    size_t pos = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+    size_t slot = 0;
+
+    for (;;)
+    {
+        slot = pos & buffer->index_mask;
+        const size_t seq = atomic_load_explicit (&buffer->sequence[slot],
+                           memory_order_acquire);
+        const intptr_t lap = (intptr_t) (seq - pos);
+
+        if (0 == lap)
+        {
+            // Slot is free on this lap, try to claim it. Failed CAS reloads pos.
+            if (atomic_compare_exchange_weak_explicit (&buffer->head, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lap < 0)
+        {
+            // Consumer of previous lap has not released the slot.
+            return RL_ERROR_NO_MEM;
+        }
+        else
+        {
+            // Another producer claimed the slot, catch up.
+            pos = atomic_load_explicit (&buffer->head, memory_order_relaxed);
+        }
+    }
+
+    memcpy ( (uint8_t *) buffer->storage + (slot * buffer->block_size), data,
+             data_length);
+    atomic_store_explicit (&buffer->sequence[slot], pos + 1, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_mpmc_dequeue (rl_ringbuffer_mpmc_t * const buffer,
+                                        void * const data,
+                                        const size_t data_length)
+{
+    if (NULL == buffer || NULL == data)         { return RL_ERROR_NULL; }
+
+    if (buffer->block_size < data_length)       { return RL_ERROR_DATA_LENGTH; }
+
+    size_t pos = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+    size_t slot = 0;
+
+    for (;;)
+    {
+        slot = pos & buffer->index_mask;
+        const size_t seq = atomic_load_explicit (&buffer->sequence[slot],
+                           memory_order_acquire);
+        const intptr_t lap = (intptr_t) (seq - (pos + 1));
+
+        if (0 == lap)
+        {
+            if (atomic_compare_exchange_weak_explicit (&buffer->tail, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lap < 0)
+        {
+            // Producer has not filled the slot yet.
+            return RL_ERROR_NO_DATA;
+        }
+        else
+        {
+            pos = atomic_load_explicit (&buffer->tail, memory_order_relaxed);
+        }
+    }
+
+    memcpy (data, (const uint8_t *) buffer->storage + (slot * buffer->block_size),
+            data_length);
+    // Free the slot for producer of the next lap.
+    atomic_store_explicit (&buffer->sequence[slot], pos + buffer->index_mask + 1,
+                           memory_order_release);
+    return RL_SUCCESS;
+}
+
+bool rl_ringbuffer_mpmc_full (const rl_ringbuffer_mpmc_t * const buffer)
+{
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    return (head - tail) > buffer->index_mask;
+}
+
+bool rl_ringbuffer_mpmc_empty (const rl_ringbuffer_mpmc_t * const buffer)
+{
+    const size_t tail = atomic_load_explicit (&buffer->tail, memory_order_acquire);
+    const size_t head = atomic_load_explicit (&buffer->head, memory_order_acquire);
+    return head == tail;
+}
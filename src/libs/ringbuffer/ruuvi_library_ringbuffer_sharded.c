@@ -0,0 +1,129 @@
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_ringbuffer_sharded.h"
+
+/**
+ * @brief Take at most half of a victim shard's elements, rounded up.
+ */
+static rl_status_t steal (rl_ringbuffer_t * const victim, void * const data,
+                          size_t * const count)
+{
+    const size_t stored = rl_ringbuffer_count (victim);
+    const size_t half = (stored + 1U) / 2U;
+
+    if (0 == stored) { return RL_ERROR_NO_DATA; }
+
+    if (half < *count)
+    {
+        *count = half;
+    }
+
+    return rl_ringbuffer_dequeue_n (victim, data, count);
+}
+
+rl_status_t rl_ringbuffer_sharded_init (rl_ringbuffer_sharded_t * const buffer)
+{
+    if (NULL == buffer || NULL == buffer->shards)  { return RL_ERROR_NULL; }
+
+    if (0 == buffer->shard_count)                  { return RL_ERROR_DATA_LENGTH; }
+
+    for (size_t ii = 0; ii < buffer->shard_count; ii++)
+    {
+        const rl_ringbuffer_t * const p_shard = &buffer->shards[ii];
+
+        if (NULL == p_shard->lock || NULL == p_shard->readlock
+                || NULL == p_shard->writelock)
+        {
+            return RL_ERROR_NULL;
+        }
+
+        if (buffer->shards[0].block_size != p_shard->block_size)
+        {
+            return RL_ERROR_DATA_LENGTH;
+        }
+    }
+
+    for (size_t ii = 0; ii < buffer->shard_count; ii++)
+    {
+        rl_ringbuffer_reset (&buffer->shards[ii]);
+    }
+
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_sharded_queue (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        const void * const data,
+        const size_t data_length)
+{
+    if (NULL == buffer)                            { return RL_ERROR_NULL; }
+
+    if (buffer->shard_count <= shard)              { return RL_ERROR_DATA_LENGTH; }
+
+    return rl_ringbuffer_queue (&buffer->shards[shard], data, data_length);
+}
+
+rl_status_t rl_ringbuffer_sharded_queue_n (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        const void * const data,
+        const size_t count)
+{
+    if (NULL == buffer)                            { return RL_ERROR_NULL; }
+
+    if (buffer->shard_count <= shard)              { return RL_ERROR_DATA_LENGTH; }
+
+    return rl_ringbuffer_queue_n (&buffer->shards[shard], data, count);
+}
+
+rl_status_t rl_ringbuffer_sharded_dequeue_n (rl_ringbuffer_sharded_t * const buffer,
+        const size_t shard,
+        void * const data,
+        size_t * const count)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == buffer || NULL == data || NULL == count) { return RL_ERROR_NULL; }
+
+    if ( (buffer->shard_count <= shard) || (0 == *count))
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    const size_t requested = *count;
+    rl_status_t busy = RL_SUCCESS;
+    err_code = rl_ringbuffer_dequeue_n (&buffer->shards[shard], data, count);
+
+    for (size_t ii = 1; (ii < buffer->shard_count) && (RL_SUCCESS != err_code); ii++)
+    {
+        // Empty shard ends up as NO_DATA, a busy one is remembered and skipped.
+        busy |= (err_code & RL_ERROR_CONCURRENCY);
+
+        if (RL_ERROR_FATAL & err_code) { return err_code; }
+
+        *count = requested;
+        err_code = steal (&buffer->shards[ (shard + ii) % buffer->shard_count], data, count);
+    }
+
+    busy |= (err_code & RL_ERROR_CONCURRENCY);
+
+    if (RL_SUCCESS != err_code)
+    {
+        *count = 0;
+        err_code = (RL_ERROR_FATAL & err_code) ? err_code :
+                   ( (RL_SUCCESS != busy) ? RL_ERROR_CONCURRENCY : RL_ERROR_NO_DATA);
+    }
+
+    return err_code;
+}
+
+size_t rl_ringbuffer_sharded_count (const rl_ringbuffer_sharded_t * const buffer)
+{
+    size_t count = 0;
+
+    for (size_t ii = 0; ii < buffer->shard_count; ii++)
+    {
+        count += rl_ringbuffer_count (&buffer->shards[ii]);
+    }
+
+    return count;
+}
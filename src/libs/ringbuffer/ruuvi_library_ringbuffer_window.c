@@ -0,0 +1,177 @@
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer_window.h"
+#include <math.h>
+#include <stdbool.h>
+
+/**
+ * @brief Recompute sums from stored samples around the current mean.
+ */
+static rl_status_t window_refresh (rl_ringbuffer_window_t * const window)
+{
+    rl_ringbuffer_span_t spans[2];
+    const size_t finite = window->count - window->nonfinite;
+    const float shift = (0 < finite) ? window->shift + (window->sum / finite) : 0.0F;
+    float sum = 0;
+    float sum_squares = 0;
+    rl_status_t err_code = rl_ringbuffer_peek_range (window->samples, 0, window->count,
+                           spans);
+
+    if (RL_SUCCESS == err_code)
+    {
+        for (size_t span = 0; span < 2; span++)
+        {
+            const float * const p_data = spans[span].data;
+
+            for (size_t ii = 0; ii < spans[span].count; ii++)
+            {
+                if (isfinite (p_data[ii]))
+                {
+                    const float delta = p_data[ii] - shift;
+                    sum += delta;
+                    sum_squares += delta * delta;
+                }
+            }
+        }
+
+        window->shift = shift;
+        window->sum = sum;
+        window->sum_squares = sum_squares;
+        window->since_refresh = 0;
+    }
+
+    return err_code;
+}
+
+static rl_status_t window_evict (rl_ringbuffer_window_t * const window)
+{
+    float * p_sample = NULL;
+    rl_status_t err_code = rl_ringbuffer_dequeue (window->samples, &p_sample);
+
+    if (RL_SUCCESS == err_code)
+    {
+        const float sample = *p_sample;
+
+        if (isfinite (sample))
+        {
+            const float delta = sample - window->shift;
+            window->sum -= delta;
+            window->sum_squares -= delta * delta;
+        }
+        else
+        {
+            window->nonfinite--;
+        }
+
+        window->count--;
+    }
+
+    return err_code;
+}
+
+rl_status_t rl_ringbuffer_window_init (rl_ringbuffer_window_t * const window)
+{
+    if (NULL == window || NULL == window->samples) { return RL_ERROR_NULL; }
+
+    if ( (0 == window->length) || (window->length > window->samples->index_mask)
+            || (window->length != window->extrema.length)
+            || (sizeof (float) != window->samples->block_size))
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    rl_status_t err_code = rl_peak2peak_window_init (&window->extrema);
+
+    if (RL_SUCCESS != err_code) { return err_code; }
+
+    rl_ringbuffer_reset (window->samples);
+    window->count = 0;
+    window->nonfinite = 0;
+    window->since_refresh = 0;
+    window->shift = 0;
+    window->sum = 0;
+    window->sum_squares = 0;
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_ringbuffer_window_push (rl_ringbuffer_window_t * const window,
+                                       const float sample)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == window) { return RL_ERROR_NULL; }
+
+    if (window->length == window->count)
+    {
+        err_code |= window_evict (window);
+    }
+
+    if (RL_SUCCESS == err_code)
+    {
+        err_code |= rl_ringbuffer_queue (window->samples, &sample, sizeof (sample));
+    }
+
+    if (RL_SUCCESS == err_code)
+    {
+        if (isfinite (sample))
+        {
+            // First sample of an empty window is a good guess for the mean.
+            if (window->count == window->nonfinite)
+            {
+                window->shift = sample;
+                window->sum = 0;
+                window->sum_squares = 0;
+            }
+
+            const float delta = sample - window->shift;
+            window->sum += delta;
+            window->sum_squares += delta * delta;
+        }
+        else
+        {
+            window->nonfinite++;
+        }
+
+        err_code |= rl_peak2peak_window_push (&window->extrema, sample);
+
+        window->count++;
+        window->since_refresh++;
+
+        if (window->length <= window->since_refresh)
+        {
+            err_code |= window_refresh (window);
+        }
+    }
+
+    return err_code;
+}
+
+float rl_ringbuffer_window_mean (const rl_ringbuffer_window_t * const window)
+{
+    if (NULL == window || 0 == window->count || 0 != window->nonfinite) { return NAN; }
+
+    return window->shift + (window->sum / window->count);
+}
+
+float rl_ringbuffer_window_variance (const rl_ringbuffer_window_t * const window)
+{
+    if (NULL == window || 0 == window->count || 0 != window->nonfinite) { return NAN; }
+
+    const float mean_delta = window->sum / window->count;
+    const float variance = (window->sum_squares / window->count) - (mean_delta * mean_delta);
+    // Rounding can leave a tiny negative residue for a constant signal.
+    return (variance > 0.0F) ? variance : 0.0F;
+}
+
+float rl_ringbuffer_window_rms (const rl_ringbuffer_window_t * const window)
+{
+    const float mean = rl_ringbuffer_window_mean (window);
+    const float variance = rl_ringbuffer_window_variance (window);
+    return sqrtf (variance + (mean * mean));
+}
+
+float rl_ringbuffer_window_peak2peak (const rl_ringbuffer_window_t * const window)
+{
+    if (NULL == window || 0 == window->count || 0 != window->nonfinite) { return NAN; }
+
+    return rl_peak2peak_window_value (&window->extrema);
+}
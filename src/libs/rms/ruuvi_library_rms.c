@@ -1,6 +1,7 @@
 // See header file for copyright etc.
 
 #include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
 #include <float.h>
 #include <math.h>
 
@@ -13,13 +14,8 @@ float rl_rms (const float * const data, const size_t data_length)
     float delta_sum = 0;
     float mean = 0;
 
-    // Calculate squares.
-    for (size_t ii = 0; ii < data_length; ii++)
-    {
-        if (!isfinite (data[ii])) { return NAN; }
-
-        delta_sum += powf (data[ii], 2);
-    }
+    // Calculate squares, finiteness is checked in same pass.
+    if (!rl_simd_square_sum (data, data_length, &delta_sum)) { return NAN; }
 
     // Calculate mean
     mean = delta_sum / data_length;
@@ -29,4 +25,45 @@ float rl_rms (const float * const data, const size_t data_length)
     // root
     rvalue = sqrtf (mean);
     return rvalue;
-}
\ No newline at end of file
+}
+
+float rl_rms_i16 (const int16_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    int64_t sum = 0;
+    uint64_t square_sum = 0;
+    rl_simd_sum_i16 (data, data_length, &sum, &square_sum);
+    return (float) sqrt ( (double) square_sum / (double) data_length);
+}
+
+float rl_rms_i32 (const int32_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    double square_sum = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const double value = data[ii];
+        square_sum += value * value;
+    }
+
+    return (float) sqrt (square_sum / (double) data_length);
+}
+
+float rl_rms_strided (const float * const data, const size_t data_length,
+                      const size_t stride)
+{
+    if (NULL == data || 0 == data_length || 0 == stride) { return NAN; }
+
+    if (1U == stride) { return rl_rms (data, data_length); }
+
+    float square_sum = 0;
+
+    if (!rl_simd_square_sum_strided (data, data_length, stride, &square_sum)) { return NAN; }
+
+    if (!isfinite (square_sum)) { return NAN; }
+
+    return sqrtf (square_sum / data_length);
+}
@@ -0,0 +1,1033 @@
+// See header file for copyright etc.
+
+#include "ruuvi_library_simd.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#if (defined (__x86_64__) || defined (__i386__)) && defined (__GNUC__)
+#   define RL_SIMD_X86 1
+#   include <immintrin.h>
+#else
+#   define RL_SIMD_X86 0
+#endif
+
+// 32-bit ARM NEON flushes subnormals to zero, only AArch64 is IEEE compliant.
+#if defined (__aarch64__) && defined (__ARM_NEON)
+#   define RL_SIMD_ARM_NEON 1
+#   include <arm_neon.h>
+#else
+#   define RL_SIMD_ARM_NEON 0
+#endif
+
+/**
+ * @brief Reduction kernels of one instruction set.
+ */
+typedef struct
+{
+    bool (*sum) (const float * const data, const size_t data_length, float * const sum);
+    bool (*square_sum) (const float * const data, const size_t data_length,
+                        float * const sum);
+    float (*deviation_square_sum) (const float * const data, const size_t data_length,
+                                   const float mean);
+    bool (*min_max) (const float * const data, const size_t data_length,
+                     float * const min, float * const max);
+    void (*sum_i16) (const int16_t * const data, const size_t data_length,
+                     int64_t * const sum, uint64_t * const square_sum);
+    void (*min_max_i16) (const int16_t * const data, const size_t data_length,
+                         int16_t * const min, int16_t * const max);
+} kernels_t;
+
+/**
+ * @brief Vector steps summed in 32-bit lanes before widening.
+ *
+ * A lane gains at most 2 * 32768 per step, so 4096 steps stay far below 2^31.
+ */
+#define I16_BLOCK_STEPS (4096U)
+
+static bool scalar_sum (const float * const data, const size_t data_length,
+                        float * const sum)
+{
+    float total = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        if (!isfinite (data[ii])) { return false; }
+
+        total += data[ii];
+    }
+
+    *sum = total;
+    return true;
+}
+
+static bool scalar_square_sum (const float * const data, const size_t data_length,
+                               float * const sum)
+{
+    float total = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        if (!isfinite (data[ii])) { return false; }
+
+        total += data[ii] * data[ii];
+    }
+
+    *sum = total;
+    return true;
+}
+
+static float scalar_deviation_square_sum (const float * const data,
+        const size_t data_length, const float mean)
+{
+    float total = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const float delta = data[ii] - mean;
+        total += delta * delta;
+    }
+
+    return total;
+}
+
+static bool scalar_min_max (const float * const data, const size_t data_length,
+                            float * const min, float * const max)
+{
+    float low = data[0];
+    float high = data[0];
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        if (!isfinite (data[ii])) { return false; }
+
+        if (data[ii] < low) { low = data[ii]; }
+
+        if (data[ii] > high) { high = data[ii]; }
+    }
+
+    *min = low;
+    *max = high;
+    return true;
+}
+
+static void scalar_sum_i16 (const int16_t * const data, const size_t data_length,
+                            int64_t * const sum, uint64_t * const square_sum)
+{
+    int64_t total = 0;
+    uint64_t squares = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const int32_t value = data[ii];
+        total += value;
+        squares += (uint32_t) (value * value);
+    }
+
+    *sum = total;
+    *square_sum = squares;
+}
+
+/**
+ * @brief Update min and max with counts, min and max hold initial values.
+ */
+static void scalar_min_max_i16 (const int16_t * const data, const size_t data_length,
+                                int16_t * const min, int16_t * const max)
+{
+    int16_t low = *min;
+    int16_t high = *max;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        low = (data[ii] < low) ? data[ii] : low;
+        high = (data[ii] > high) ? data[ii] : high;
+    }
+
+    *min = low;
+    *max = high;
+}
+
+static const kernels_t scalar_kernels =
+{
+    .sum = &scalar_sum,
+    .square_sum = &scalar_square_sum,
+    .deviation_square_sum = &scalar_deviation_square_sum,
+    .min_max = &scalar_min_max,
+    .sum_i16 = &scalar_sum_i16,
+    .min_max_i16 = &scalar_min_max_i16
+};
+
+#if RL_SIMD_X86
+
+/**
+ * @brief Combine 4 vector lanes of min and max with the scalar tail after last vector.
+ */
+static bool finish_min_max (const float * const data, const size_t start,
+                            const size_t data_length, const float low[4], const float high[4],
+                            float * const min, float * const max)
+{
+    float tail_min = low[0];
+    float tail_max = high[0];
+    const bool finite = (start == data_length)
+                        || scalar_min_max (&data[start], data_length - start, &tail_min, &tail_max);
+    *min = tail_min;
+    *max = tail_max;
+
+    for (size_t lane = 0; lane < 4U; lane++)
+    {
+        *min = (low[lane] < *min) ? low[lane] : *min;
+        *max = (high[lane] > *max) ? high[lane] : *max;
+    }
+
+    return finite;
+}
+
+__attribute__ ((target ("sse2")))
+static inline float sse2_hsum (const __m128 v)
+{
+    const __m128 swapped = _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1));
+    const __m128 pairs = _mm_add_ps (v, swapped);
+    return _mm_cvtss_f32 (_mm_add_ss (pairs, _mm_movehl_ps (swapped, pairs)));
+}
+
+/**
+ * @brief Clear mask lanes where x is NAN or infinite, as x - x is then NAN.
+ */
+__attribute__ ((target ("sse2")))
+static inline __m128 sse2_finite (const __m128 mask, const __m128 x)
+{
+    return _mm_and_ps (mask, _mm_cmpeq_ps (_mm_sub_ps (x, x), _mm_setzero_ps()));
+}
+
+__attribute__ ((target ("sse2")))
+static inline bool sse2_all (const __m128 mask)
+{
+    return 0xF == _mm_movemask_ps (mask);
+}
+
+__attribute__ ((target ("sse2")))
+static bool sse2_sum (const float * const data, const size_t data_length,
+                      float * const sum)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 finite = _mm_castsi128_ps (_mm_set1_epi32 (-1));
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const __m128 x0 = _mm_loadu_ps (&data[ii]);
+        const __m128 x1 = _mm_loadu_ps (&data[ii + 4U]);
+        finite = sse2_finite (sse2_finite (finite, x0), x1);
+        acc0 = _mm_add_ps (acc0, x0);
+        acc1 = _mm_add_ps (acc1, x1);
+    }
+
+    const bool tail_finite = scalar_sum (&data[ii], data_length - ii, &tail);
+    *sum = sse2_hsum (_mm_add_ps (acc0, acc1)) + tail;
+    return sse2_all (finite) && tail_finite;
+}
+
+__attribute__ ((target ("sse2")))
+static bool sse2_square_sum (const float * const data, const size_t data_length,
+                             float * const sum)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 finite = _mm_castsi128_ps (_mm_set1_epi32 (-1));
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const __m128 x0 = _mm_loadu_ps (&data[ii]);
+        const __m128 x1 = _mm_loadu_ps (&data[ii + 4U]);
+        finite = sse2_finite (sse2_finite (finite, x0), x1);
+        acc0 = _mm_add_ps (acc0, _mm_mul_ps (x0, x0));
+        acc1 = _mm_add_ps (acc1, _mm_mul_ps (x1, x1));
+    }
+
+    const bool tail_finite = scalar_square_sum (&data[ii], data_length - ii, &tail);
+    *sum = sse2_hsum (_mm_add_ps (acc0, acc1)) + tail;
+    return sse2_all (finite) && tail_finite;
+}
+
+__attribute__ ((target ("sse2")))
+static float sse2_deviation_square_sum (const float * const data,
+                                        const size_t data_length, const float mean)
+{
+    const __m128 center = _mm_set1_ps (mean);
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const __m128 d0 = _mm_sub_ps (_mm_loadu_ps (&data[ii]), center);
+        const __m128 d1 = _mm_sub_ps (_mm_loadu_ps (&data[ii + 4U]), center);
+        acc0 = _mm_add_ps (acc0, _mm_mul_ps (d0, d0));
+        acc1 = _mm_add_ps (acc1, _mm_mul_ps (d1, d1));
+    }
+
+    return sse2_hsum (_mm_add_ps (acc0, acc1))
+           + scalar_deviation_square_sum (&data[ii], data_length - ii, mean);
+}
+
+__attribute__ ((target ("sse2")))
+static bool sse2_min_max (const float * const data, const size_t data_length,
+                          float * const min, float * const max)
+{
+    __m128 low = _mm_set1_ps (data[0]);
+    __m128 high = low;
+    __m128 finite = _mm_castsi128_ps (_mm_set1_epi32 (-1));
+    size_t ii = 0;
+
+    for (; (ii + 4U) <= data_length; ii += 4U)
+    {
+        const __m128 x = _mm_loadu_ps (&data[ii]);
+        finite = sse2_finite (finite, x);
+        low = _mm_min_ps (low, x);
+        high = _mm_max_ps (high, x);
+    }
+
+    float low_lanes[4];
+    float high_lanes[4];
+    _mm_storeu_ps (low_lanes, low);
+    _mm_storeu_ps (high_lanes, high);
+    const bool tail_finite = finish_min_max (data, ii, data_length, low_lanes, high_lanes,
+                             min, max);
+    return sse2_all (finite) && tail_finite;
+}
+
+/**
+ * @brief Sum counts and their squares with pmaddwd.
+ *
+ * Multiply-add of a pair of squares reaches 2^31 only for two INT16_MIN counts,
+ * which is still exact read as unsigned, so squares are widened to 64 bits every step.
+ */
+__attribute__ ((target ("sse2")))
+static void sse2_sum_i16 (const int16_t * const data, const size_t data_length,
+                          int64_t * const sum, uint64_t * const square_sum)
+{
+    const __m128i ones = _mm_set1_epi16 (1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i squares = zero;
+    int64_t total = 0;
+    size_t ii = 0;
+
+    while ( (ii + 8U) <= data_length)
+    {
+        const size_t end = ( (data_length - ii) > (8U * I16_BLOCK_STEPS)) ?
+                           ii + (8U * I16_BLOCK_STEPS) : data_length;
+        __m128i sums = zero;
+
+        for (; (ii + 8U) <= end; ii += 8U)
+        {
+            const __m128i x = _mm_loadu_si128 ( (const __m128i *) &data[ii]);
+            const __m128i pairs = _mm_madd_epi16 (x, x);
+            sums = _mm_add_epi32 (sums, _mm_madd_epi16 (x, ones));
+            squares = _mm_add_epi64 (squares, _mm_unpacklo_epi32 (pairs, zero));
+            squares = _mm_add_epi64 (squares, _mm_unpackhi_epi32 (pairs, zero));
+        }
+
+        int32_t sum_lanes[4];
+        _mm_storeu_si128 ( (__m128i *) sum_lanes, sums);
+        total += (int64_t) sum_lanes[0] + sum_lanes[1] + sum_lanes[2] + sum_lanes[3];
+    }
+
+    uint64_t square_lanes[2];
+    int64_t tail = 0;
+    uint64_t tail_squares = 0;
+    _mm_storeu_si128 ( (__m128i *) square_lanes, squares);
+    scalar_sum_i16 (&data[ii], data_length - ii, &tail, &tail_squares);
+    *sum = total + tail;
+    *square_sum = square_lanes[0] + square_lanes[1] + tail_squares;
+}
+
+__attribute__ ((target ("sse2")))
+static void sse2_min_max_i16 (const int16_t * const data, const size_t data_length,
+                              int16_t * const min, int16_t * const max)
+{
+    __m128i low = _mm_set1_epi16 (*min);
+    __m128i high = _mm_set1_epi16 (*max);
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const __m128i x = _mm_loadu_si128 ( (const __m128i *) &data[ii]);
+        low = _mm_min_epi16 (low, x);
+        high = _mm_max_epi16 (high, x);
+    }
+
+    int16_t low_lanes[8];
+    int16_t high_lanes[8];
+    _mm_storeu_si128 ( (__m128i *) low_lanes, low);
+    _mm_storeu_si128 ( (__m128i *) high_lanes, high);
+    scalar_min_max_i16 (low_lanes, 8U, min, max);
+    scalar_min_max_i16 (high_lanes, 8U, min, max);
+    scalar_min_max_i16 (&data[ii], data_length - ii, min, max);
+}
+
+static const kernels_t sse2_kernels =
+{
+    .sum = &sse2_sum,
+    .square_sum = &sse2_square_sum,
+    .deviation_square_sum = &sse2_deviation_square_sum,
+    .min_max = &sse2_min_max,
+    .sum_i16 = &sse2_sum_i16,
+    .min_max_i16 = &sse2_min_max_i16
+};
+
+__attribute__ ((target ("avx2")))
+static inline float avx2_hsum (const __m256 v)
+{
+    return sse2_hsum (_mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1)));
+}
+
+__attribute__ ((target ("avx2")))
+static inline __m256 avx2_finite (const __m256 mask, const __m256 x)
+{
+    return _mm256_and_ps (mask, _mm256_cmp_ps (_mm256_sub_ps (x, x), _mm256_setzero_ps(),
+                          _CMP_EQ_OQ));
+}
+
+__attribute__ ((target ("avx2")))
+static inline bool avx2_all (const __m256 mask)
+{
+    return 0xFF == _mm256_movemask_ps (mask);
+}
+
+__attribute__ ((target ("avx2")))
+static bool avx2_sum (const float * const data, const size_t data_length,
+                      float * const sum)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 finite = _mm256_castsi256_ps (_mm256_set1_epi32 (-1));
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 16U) <= data_length; ii += 16U)
+    {
+        const __m256 x0 = _mm256_loadu_ps (&data[ii]);
+        const __m256 x1 = _mm256_loadu_ps (&data[ii + 8U]);
+        finite = avx2_finite (avx2_finite (finite, x0), x1);
+        acc0 = _mm256_add_ps (acc0, x0);
+        acc1 = _mm256_add_ps (acc1, x1);
+    }
+
+    const bool tail_finite = scalar_sum (&data[ii], data_length - ii, &tail);
+    *sum = avx2_hsum (_mm256_add_ps (acc0, acc1)) + tail;
+    return avx2_all (finite) && tail_finite;
+}
+
+__attribute__ ((target ("avx2")))
+static bool avx2_square_sum (const float * const data, const size_t data_length,
+                             float * const sum)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 finite = _mm256_castsi256_ps (_mm256_set1_epi32 (-1));
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 16U) <= data_length; ii += 16U)
+    {
+        const __m256 x0 = _mm256_loadu_ps (&data[ii]);
+        const __m256 x1 = _mm256_loadu_ps (&data[ii + 8U]);
+        finite = avx2_finite (avx2_finite (finite, x0), x1);
+        acc0 = _mm256_add_ps (acc0, _mm256_mul_ps (x0, x0));
+        acc1 = _mm256_add_ps (acc1, _mm256_mul_ps (x1, x1));
+    }
+
+    const bool tail_finite = scalar_square_sum (&data[ii], data_length - ii, &tail);
+    *sum = avx2_hsum (_mm256_add_ps (acc0, acc1)) + tail;
+    return avx2_all (finite) && tail_finite;
+}
+
+__attribute__ ((target ("avx2")))
+static float avx2_deviation_square_sum (const float * const data,
+                                        const size_t data_length, const float mean)
+{
+    const __m256 center = _mm256_set1_ps (mean);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t ii = 0;
+
+    for (; (ii + 16U) <= data_length; ii += 16U)
+    {
+        const __m256 d0 = _mm256_sub_ps (_mm256_loadu_ps (&data[ii]), center);
+        const __m256 d1 = _mm256_sub_ps (_mm256_loadu_ps (&data[ii + 8U]), center);
+        acc0 = _mm256_add_ps (acc0, _mm256_mul_ps (d0, d0));
+        acc1 = _mm256_add_ps (acc1, _mm256_mul_ps (d1, d1));
+    }
+
+    return avx2_hsum (_mm256_add_ps (acc0, acc1))
+           + scalar_deviation_square_sum (&data[ii], data_length - ii, mean);
+}
+
+__attribute__ ((target ("avx2")))
+static bool avx2_min_max (const float * const data, const size_t data_length,
+                          float * const min, float * const max)
+{
+    __m256 low = _mm256_set1_ps (data[0]);
+    __m256 high = low;
+    __m256 finite = _mm256_castsi256_ps (_mm256_set1_epi32 (-1));
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const __m256 x = _mm256_loadu_ps (&data[ii]);
+        finite = avx2_finite (finite, x);
+        low = _mm256_min_ps (low, x);
+        high = _mm256_max_ps (high, x);
+    }
+
+    float low_lanes[4];
+    float high_lanes[4];
+    _mm_storeu_ps (low_lanes, _mm_min_ps (_mm256_castps256_ps128 (low),
+                                          _mm256_extractf128_ps (low, 1)));
+    _mm_storeu_ps (high_lanes, _mm_max_ps (_mm256_castps256_ps128 (high),
+                                           _mm256_extractf128_ps (high, 1)));
+    const bool tail_finite = finish_min_max (data, ii, data_length, low_lanes, high_lanes,
+                             min, max);
+    return avx2_all (finite) && tail_finite;
+}
+
+__attribute__ ((target ("avx2")))
+static void avx2_sum_i16 (const int16_t * const data, const size_t data_length,
+                          int64_t * const sum, uint64_t * const square_sum)
+{
+    const __m256i ones = _mm256_set1_epi16 (1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i squares = zero;
+    int64_t total = 0;
+    size_t ii = 0;
+
+    while ( (ii + 16U) <= data_length)
+    {
+        const size_t end = ( (data_length - ii) > (16U * I16_BLOCK_STEPS)) ?
+                           ii + (16U * I16_BLOCK_STEPS) : data_length;
+        __m256i sums = zero;
+
+        for (; (ii + 16U) <= end; ii += 16U)
+        {
+            const __m256i x = _mm256_loadu_si256 ( (const __m256i *) &data[ii]);
+            const __m256i pairs = _mm256_madd_epi16 (x, x);
+            sums = _mm256_add_epi32 (sums, _mm256_madd_epi16 (x, ones));
+            squares = _mm256_add_epi64 (squares, _mm256_unpacklo_epi32 (pairs, zero));
+            squares = _mm256_add_epi64 (squares, _mm256_unpackhi_epi32 (pairs, zero));
+        }
+
+        int32_t sum_lanes[8];
+        _mm256_storeu_si256 ( (__m256i *) sum_lanes, sums);
+
+        for (size_t lane = 0; lane < 8U; lane++)
+        {
+            total += sum_lanes[lane];
+        }
+    }
+
+    uint64_t square_lanes[4];
+    int64_t tail = 0;
+    uint64_t tail_squares = 0;
+    _mm256_storeu_si256 ( (__m256i *) square_lanes, squares);
+    scalar_sum_i16 (&data[ii], data_length - ii, &tail, &tail_squares);
+    *sum = total + tail;
+    *square_sum = square_lanes[0] + square_lanes[1] + square_lanes[2] + square_lanes[3]
+                  + tail_squares;
+}
+
+__attribute__ ((target ("avx2")))
+static void avx2_min_max_i16 (const int16_t * const data, const size_t data_length,
+                              int16_t * const min, int16_t * const max)
+{
+    __m256i low = _mm256_set1_epi16 (*min);
+    __m256i high = _mm256_set1_epi16 (*max);
+    size_t ii = 0;
+
+    for (; (ii + 16U) <= data_length; ii += 16U)
+    {
+        const __m256i x = _mm256_loadu_si256 ( (const __m256i *) &data[ii]);
+        low = _mm256_min_epi16 (low, x);
+        high = _mm256_max_epi16 (high, x);
+    }
+
+    int16_t low_lanes[16];
+    int16_t high_lanes[16];
+    _mm256_storeu_si256 ( (__m256i *) low_lanes, low);
+    _mm256_storeu_si256 ( (__m256i *) high_lanes, high);
+    scalar_min_max_i16 (low_lanes, 16U, min, max);
+    scalar_min_max_i16 (high_lanes, 16U, min, max);
+    scalar_min_max_i16 (&data[ii], data_length - ii, min, max);
+}
+
+static const kernels_t avx2_kernels =
+{
+    .sum = &avx2_sum,
+    .square_sum = &avx2_square_sum,
+    .deviation_square_sum = &avx2_deviation_square_sum,
+    .min_max = &avx2_min_max,
+    .sum_i16 = &avx2_sum_i16,
+    .min_max_i16 = &avx2_min_max_i16
+};
+
+#endif
+
+#if RL_SIMD_ARM_NEON
+
+static inline float neon_hsum (const float32x4_t v)
+{
+    return vaddvq_f32 (v);
+}
+
+/**
+ * @brief Clear mask lanes where x is NAN or infinite, as x - x is then NAN.
+ */
+static inline uint32x4_t neon_finite (const uint32x4_t mask, const float32x4_t x)
+{
+    return vandq_u32 (mask, vceqq_f32 (vsubq_f32 (x, x), vdupq_n_f32 (0.0F)));
+}
+
+static inline bool neon_all (const uint32x4_t mask)
+{
+    return UINT32_MAX == vminvq_u32 (mask);
+}
+
+static bool neon_sum (const float * const data, const size_t data_length,
+                      float * const sum)
+{
+    float32x4_t acc0 = vdupq_n_f32 (0.0F);
+    float32x4_t acc1 = vdupq_n_f32 (0.0F);
+    uint32x4_t finite = vdupq_n_u32 (UINT32_MAX);
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const float32x4_t x0 = vld1q_f32 (&data[ii]);
+        const float32x4_t x1 = vld1q_f32 (&data[ii + 4U]);
+        finite = neon_finite (neon_finite (finite, x0), x1);
+        acc0 = vaddq_f32 (acc0, x0);
+        acc1 = vaddq_f32 (acc1, x1);
+    }
+
+    const bool tail_finite = scalar_sum (&data[ii], data_length - ii, &tail);
+    *sum = neon_hsum (vaddq_f32 (acc0, acc1)) + tail;
+    return neon_all (finite) && tail_finite;
+}
+
+static bool neon_square_sum (const float * const data, const size_t data_length,
+                             float * const sum)
+{
+    float32x4_t acc0 = vdupq_n_f32 (0.0F);
+    float32x4_t acc1 = vdupq_n_f32 (0.0F);
+    uint32x4_t finite = vdupq_n_u32 (UINT32_MAX);
+    float tail = 0;
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const float32x4_t x0 = vld1q_f32 (&data[ii]);
+        const float32x4_t x1 = vld1q_f32 (&data[ii + 4U]);
+        finite = neon_finite (neon_finite (finite, x0), x1);
+        // Separate multiply and add, a fused vfmaq would round differently.
+        acc0 = vaddq_f32 (acc0, vmulq_f32 (x0, x0));
+        acc1 = vaddq_f32 (acc1, vmulq_f32 (x1, x1));
+    }
+
+    const bool tail_finite = scalar_square_sum (&data[ii], data_length - ii, &tail);
+    *sum = neon_hsum (vaddq_f32 (acc0, acc1)) + tail;
+    return neon_all (finite) && tail_finite;
+}
+
+static float neon_deviation_square_sum (const float * const data,
+                                        const size_t data_length, const float mean)
+{
+    const float32x4_t center = vdupq_n_f32 (mean);
+    float32x4_t acc0 = vdupq_n_f32 (0.0F);
+    float32x4_t acc1 = vdupq_n_f32 (0.0F);
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const float32x4_t d0 = vsubq_f32 (vld1q_f32 (&data[ii]), center);
+        const float32x4_t d1 = vsubq_f32 (vld1q_f32 (&data[ii + 4U]), center);
+        acc0 = vaddq_f32 (acc0, vmulq_f32 (d0, d0));
+        acc1 = vaddq_f32 (acc1, vmulq_f32 (d1, d1));
+    }
+
+    return neon_hsum (vaddq_f32 (acc0, acc1))
+           + scalar_deviation_square_sum (&data[ii], data_length - ii, mean);
+}
+
+static bool neon_min_max (const float * const data, const size_t data_length,
+                          float * const min, float * const max)
+{
+    float32x4_t low = vdupq_n_f32 (data[0]);
+    float32x4_t high = low;
+    uint32x4_t finite = vdupq_n_u32 (UINT32_MAX);
+    size_t ii = 0;
+
+    for (; (ii + 4U) <= data_length; ii += 4U)
+    {
+        const float32x4_t x = vld1q_f32 (&data[ii]);
+        finite = neon_finite (finite, x);
+        low = vminq_f32 (low, x);
+        high = vmaxq_f32 (high, x);
+    }
+
+    float tail_min = data[0];
+    float tail_max = data[0];
+    const bool tail_finite = (ii == data_length)
+                             || scalar_min_max (&data[ii], data_length - ii, &tail_min, &tail_max);
+    const float lane_min = vminvq_f32 (low);
+    const float lane_max = vmaxvq_f32 (high);
+    *min = (lane_min < tail_min) ? lane_min : tail_min;
+    *max = (lane_max > tail_max) ? lane_max : tail_max;
+    return neon_all (finite) && tail_finite;
+}
+
+static void neon_sum_i16 (const int16_t * const data, const size_t data_length,
+                          int64_t * const sum, uint64_t * const square_sum)
+{
+    int64x2_t squares = vdupq_n_s64 (0);
+    int64_t total = 0;
+    size_t ii = 0;
+
+    while ( (ii + 8U) <= data_length)
+    {
+        const size_t end = ( (data_length - ii) > (8U * I16_BLOCK_STEPS)) ?
+                           ii + (8U * I16_BLOCK_STEPS) : data_length;
+        int32x4_t sums = vdupq_n_s32 (0);
+
+        for (; (ii + 8U) <= end; ii += 8U)
+        {
+            const int16x8_t x = vld1q_s16 (&data[ii]);
+            const int16x4_t x_low = vget_low_s16 (x);
+            const int16x4_t x_high = vget_high_s16 (x);
+            // Single squares are at most 2^30, pairwise widening add can't overflow.
+            sums = vpadalq_s16 (sums, x);
+            squares = vpadalq_s32 (squares, vmull_s16 (x_low, x_low));
+            squares = vpadalq_s32 (squares, vmull_s16 (x_high, x_high));
+        }
+
+        total += vaddlvq_s32 (sums);
+    }
+
+    int64_t tail = 0;
+    uint64_t tail_squares = 0;
+    scalar_sum_i16 (&data[ii], data_length - ii, &tail, &tail_squares);
+    *sum = total + tail;
+    *square_sum = (uint64_t) vaddvq_s64 (squares) + tail_squares;
+}
+
+static void neon_min_max_i16 (const int16_t * const data, const size_t data_length,
+                              int16_t * const min, int16_t * const max)
+{
+    int16x8_t low = vdupq_n_s16 (*min);
+    int16x8_t high = vdupq_n_s16 (*max);
+    size_t ii = 0;
+
+    for (; (ii + 8U) <= data_length; ii += 8U)
+    {
+        const int16x8_t x = vld1q_s16 (&data[ii]);
+        low = vminq_s16 (low, x);
+        high = vmaxq_s16 (high, x);
+    }
+
+    *min = vminvq_s16 (low);
+    *max = vmaxvq_s16 (high);
+    scalar_min_max_i16 (&data[ii], data_length - ii, min, max);
+}
+
+static const kernels_t neon_kernels =
+{
+    .sum = &neon_sum,
+    .square_sum = &neon_square_sum,
+    .deviation_square_sum = &neon_deviation_square_sum,
+    .min_max = &neon_min_max,
+    .sum_i16 = &neon_sum_i16,
+    .min_max_i16 = &neon_min_max_i16
+};
+
+#endif
+
+/** @brief Kernels per level, NULL if level is not compiled in. */
+static const kernels_t * const m_tables[] =
+{
+    [RL_SIMD_SCALAR] = &scalar_kernels,
+#if RL_SIMD_X86
+    [RL_SIMD_SSE2] = &sse2_kernels,
+    [RL_SIMD_AVX2] = &avx2_kernels,
+#endif
+#if RL_SIMD_ARM_NEON
+    [RL_SIMD_NEON] = &neon_kernels,
+#endif
+};
+
+#define LEVEL_COUNT (RL_SIMD_NEON + 1)
+
+static _Atomic rl_simd_level_t m_level = RL_SIMD_SCALAR;
+static atomic_bool m_detected = false;
+
+static bool level_supported (const rl_simd_level_t level)
+{
+    bool supported = false;
+
+    if ( (level < (sizeof (m_tables) / sizeof (m_tables[0]))) && (NULL != m_tables[level]))
+    {
+#if RL_SIMD_X86
+        __builtin_cpu_init();
+        supported = (RL_SIMD_SCALAR == level)
+                    || ( (RL_SIMD_SSE2 == level) && __builtin_cpu_supports ("sse2"))
+                    || ( (RL_SIMD_AVX2 == level) && __builtin_cpu_supports ("avx2"));
+#else
+        // NEON is mandatory on AArch64, scalar is always available.
+        supported = true;
+#endif
+    }
+
+    return supported;
+}
+
+/**
+ * @brief Kernels of current level, best supported level is detected on first call.
+ *
+ * Threads racing through detection store the same level.
+ */
+static const kernels_t * kernels (void)
+{
+    if (!atomic_load_explicit (&m_detected, memory_order_acquire))
+    {
+        rl_simd_level_t best = RL_SIMD_SCALAR;
+
+        for (int level = LEVEL_COUNT - 1; level > RL_SIMD_SCALAR; level--)
+        {
+            if (level_supported ( (rl_simd_level_t) level))
+            {
+                best = (rl_simd_level_t) level;
+                break;
+            }
+        }
+
+        atomic_store_explicit (&m_level, best, memory_order_relaxed);
+        atomic_store_explicit (&m_detected, true, memory_order_release);
+    }
+
+    return m_tables[atomic_load_explicit (&m_level, memory_order_relaxed)];
+}
+
+static _Atomic rl_simd_accumulation_t m_accumulation = RL_SIMD_ACCUMULATE_PAIRWISE;
+
+/** @brief Sum computed by kernels. */
+typedef enum
+{
+    OP_SUM,
+    OP_SQUARE_SUM,
+    OP_DEVIATION_SQUARE_SUM
+} op_t;
+
+/**
+ * @brief Sum of every stride:th value, scalar as gathers don't pay off for sums.
+ */
+static bool strided_sum (const op_t op, const float * const data,
+                         const size_t data_length, const size_t stride,
+                         const float mean, float * const sum)
+{
+    float total = 0;
+    bool finite = true;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const float value = data[ii * stride];
+        const float term = (OP_DEVIATION_SQUARE_SUM == op) ? value - mean : value;
+        finite = finite && isfinite (value);
+        total += (OP_SUM == op) ? term : term * term;
+    }
+
+    *sum = total;
+    // Deviation square sum is not checked, like the kernels.
+    return finite || (OP_DEVIATION_SQUARE_SUM == op);
+}
+
+static bool kernel_sum (const kernels_t * const table, const op_t op,
+                        const float * const data, const size_t data_length,
+                        const size_t stride, const float mean, float * const sum)
+{
+    bool finite = true;
+
+    if (1U != stride)
+    {
+        return strided_sum (op, data, data_length, stride, mean, sum);
+    }
+
+    switch (op)
+    {
+        case OP_SUM:
+            finite = table->sum (data, data_length, sum);
+            break;
+
+        case OP_SQUARE_SUM:
+            finite = table->square_sum (data, data_length, sum);
+            break;
+
+        default:
+            *sum = table->deviation_square_sum (data, data_length, mean);
+            break;
+    }
+
+    return finite;
+}
+
+/**
+ * @brief Sum blocks with kernel and add block sums pairwise.
+ *
+ * Works like a binary counter: partial[level] holds the sum of 2^level blocks,
+ * and equal sized sums are added whenever a carry propagates. No recursion and
+ * a fixed 64 float stack regardless of input length. Blocks are
+ * RL_SIMD_BLOCK_LENGTH values at any stride, so every stride gets the same bound.
+ */
+static bool accumulate (const op_t op, const float * const data,
+                        const size_t data_length, const size_t stride,
+                        const float mean, float * const sum)
+{
+    const kernels_t * const table = kernels();
+
+    if ( (data_length <= RL_SIMD_BLOCK_LENGTH)
+            || (RL_SIMD_ACCUMULATE_FLOAT == atomic_load_explicit (&m_accumulation,
+                    memory_order_relaxed)))
+    {
+        return kernel_sum (table, op, data, data_length, stride, mean, sum);
+    }
+
+    float partial[64];
+    size_t blocks = 0;
+    bool finite = true;
+
+    for (size_t start = 0; start < data_length; start += RL_SIMD_BLOCK_LENGTH)
+    {
+        const size_t remaining = data_length - start;
+        const size_t count = (remaining < RL_SIMD_BLOCK_LENGTH) ? remaining :
+                             RL_SIMD_BLOCK_LENGTH;
+        float block = 0;
+        size_t level = 0;
+        finite = kernel_sum (table, op, &data[start * stride], count, stride, mean, &block)
+                 && finite;
+        blocks++;
+
+        for (size_t carry = blocks; 0U == (carry & 1U); carry >>= 1U)
+        {
+            block += partial[level];
+            level++;
+        }
+
+        partial[level] = block;
+    }
+
+    // Add remaining partial sums from smallest to largest.
+    float total = 0;
+    size_t level = 0;
+
+    for (size_t carry = blocks; 0U != carry; carry >>= 1U)
+    {
+        if (carry & 1U) { total += partial[level]; }
+
+        level++;
+    }
+
+    *sum = total;
+    return finite;
+}
+
+rl_simd_level_t rl_simd_level (void)
+{
+    kernels();
+    return atomic_load_explicit (&m_level, memory_order_relaxed);
+}
+
+rl_status_t rl_simd_select (const rl_simd_level_t level)
+{
+    if (!level_supported (level)) { return RL_ERROR_INTERNAL; }
+
+    atomic_store_explicit (&m_level, level, memory_order_relaxed);
+    atomic_store_explicit (&m_detected, true, memory_order_release);
+    return RL_SUCCESS;
+}
+
+rl_simd_accumulation_t rl_simd_accumulation (void)
+{
+    return atomic_load_explicit (&m_accumulation, memory_order_relaxed);
+}
+
+rl_status_t rl_simd_accumulation_select (const rl_simd_accumulation_t mode)
+{
+    if ( (RL_SIMD_ACCUMULATE_PAIRWISE != mode) && (RL_SIMD_ACCUMULATE_FLOAT != mode))
+    {
+        return RL_ERROR_INTERNAL;
+    }
+
+    atomic_store_explicit (&m_accumulation, mode, memory_order_relaxed);
+    return RL_SUCCESS;
+}
+
+bool rl_simd_sum (const float * const data, const size_t data_length,
+                  float * const sum)
+{
+    return accumulate (OP_SUM, data, data_length, 1U, 0.0F, sum);
+}
+
+bool rl_simd_square_sum (const float * const data, const size_t data_length,
+                         float * const sum)
+{
+    return accumulate (OP_SQUARE_SUM, data, data_length, 1U, 0.0F, sum);
+}
+
+float rl_simd_deviation_square_sum (const float * const data, const size_t data_length,
+                                    const float mean)
+{
+    float sum = 0;
+    accumulate (OP_DEVIATION_SQUARE_SUM, data, data_length, 1U, mean, &sum);
+    return sum;
+}
+
+bool rl_simd_sum_strided (const float * const data, const size_t data_length,
+                          const size_t stride, float * const sum)
+{
+    return accumulate (OP_SUM, data, data_length, stride, 0.0F, sum);
+}
+
+bool rl_simd_square_sum_strided (const float * const data, const size_t data_length,
+                                 const size_t stride, float * const sum)
+{
+    return accumulate (OP_SQUARE_SUM, data, data_length, stride, 0.0F, sum);
+}
+
+float rl_simd_deviation_square_sum_strided (const float * const data,
+        const size_t data_length, const size_t stride, const float mean)
+{
+    float sum = 0;
+    accumulate (OP_DEVIATION_SQUARE_SUM, data, data_length, stride, mean, &sum);
+    return sum;
+}
+
+bool rl_simd_min_max (const float * const data, const size_t data_length,
+                      float * const min, float * const max)
+{
+    return kernels()->min_max (data, data_length, min, max);
+}
+
+void rl_simd_sum_i16 (const int16_t * const data, const size_t data_length,
+                      int64_t * const sum, uint64_t * const square_sum)
+{
+    kernels()->sum_i16 (data, data_length, sum, square_sum);
+}
+
+void rl_simd_min_max_i16 (const int16_t * const data, const size_t data_length,
+                          int16_t * const min, int16_t * const max)
+{
+    *min = data[0];
+    *max = data[0];
+    kernels()->min_max_i16 (data, data_length, min, max);
+}
@@ -0,0 +1,190 @@
+// See header file for copyright etc.
+
+#include "ruuvi_library_stats.h"
+#include "ruuvi_library_simd.h"
+#include <math.h>
+
+static void stats_invalidate (rl_stats_t * const stats)
+{
+    stats->mean = NAN;
+    stats->variance = NAN;
+    stats->rms = NAN;
+    stats->min = NAN;
+    stats->max = NAN;
+    stats->peak2peak = NAN;
+}
+
+static inline float finite_or_nan (const float value)
+{
+    return isfinite (value) ? value : NAN;
+}
+
+/**
+ * @brief Float sums of one channel over one block of rows.
+ */
+typedef struct
+{
+    float delta_sum;        //!< Sum of differences to shift.
+    float delta_square_sum; //!< Sum of squared differences to shift.
+    float square_sum;       //!< Sum of squares.
+} block_sums_t;
+
+/**
+ * @brief Running sums of one channel.
+ *
+ * Block sums are added in double, like @ref rl_moments_push_n merges its blocks,
+ * so error doesn't grow with the number of blocks and no per-channel stack of
+ * pairwise partial sums is needed.
+ */
+typedef struct
+{
+    float shift;             //!< First value, sums are taken around it.
+    double delta_sum;        //!< Sum of differences to shift.
+    double delta_square_sum; //!< Sum of squared differences to shift.
+    double square_sum;       //!< Sum of squares.
+    float min;               //!< Smallest value.
+    float max;               //!< Largest value.
+    bool finite;             //!< False after a NAN or infinite value.
+} channel_sums_t;
+
+static void channel_finish (const channel_sums_t * const sums, const size_t data_length,
+                            rl_stats_t * const stats)
+{
+    const double delta_mean = sums->delta_sum / data_length;
+    const double variance = (sums->delta_square_sum / data_length)
+                            - (delta_mean * delta_mean);
+    stats->mean = finite_or_nan ( (float) (sums->shift + delta_mean));
+    // Rounding can leave a tiny negative residue for a constant signal.
+    stats->variance = isfinite (sums->delta_square_sum) ?
+                      finite_or_nan ( (variance > 0.0) ? (float) variance : 0.0F) : NAN;
+    stats->rms = isfinite (sums->square_sum) ?
+                 finite_or_nan ( (float) sqrt (sums->square_sum / data_length)) : NAN;
+    stats->min = sums->min;
+    stats->max = sums->max;
+    stats->peak2peak = finite_or_nan (sums->max - sums->min);
+}
+
+/**
+ * @brief Accumulate channels consecutive values of every row in one pass.
+ *
+ * Inlined into callers, so a constant channel count unrolls the inner loop.
+ * Rows are summed in float over blocks of RL_SIMD_BLOCK_LENGTH, or over the whole
+ * input with @ref RL_SIMD_ACCUMULATE_FLOAT.
+ */
+static inline void channels_accumulate (const float * const data, const size_t data_length,
+                                        const size_t stride, const size_t channels,
+                                        channel_sums_t * const sums)
+{
+    for (size_t channel = 0; channel < channels; channel++)
+    {
+        sums[channel] = (channel_sums_t)
+        {
+            .shift = data[channel], .min = data[channel], .max = data[channel], .finite = true
+        };
+    }
+
+    const size_t block_length = (RL_SIMD_ACCUMULATE_FLOAT == rl_simd_accumulation()) ?
+                                data_length : RL_SIMD_BLOCK_LENGTH;
+
+    for (size_t start = 0; start < data_length; start += block_length)
+    {
+        const size_t end = ( (data_length - start) > block_length) ?
+                           start + block_length : data_length;
+        block_sums_t blocks[RL_STATS_MAX_CHANNELS] = {0};
+
+        for (size_t ii = start; ii < end; ii++)
+        {
+            const float * const row = &data[ii * stride];
+
+            for (size_t channel = 0; channel < channels; channel++)
+            {
+                channel_sums_t * const sum = &sums[channel];
+                block_sums_t * const block = &blocks[channel];
+                const float value = row[channel];
+                const float delta = value - sum->shift;
+                sum->finite = sum->finite && isfinite (value);
+                block->delta_sum += delta;
+                block->delta_square_sum += delta * delta;
+                block->square_sum += value * value;
+
+                if (value < sum->min) { sum->min = value; }
+
+                if (value > sum->max) { sum->max = value; }
+            }
+        }
+
+        for (size_t channel = 0; channel < channels; channel++)
+        {
+            sums[channel].delta_sum += blocks[channel].delta_sum;
+            sums[channel].delta_square_sum += blocks[channel].delta_square_sum;
+            sums[channel].square_sum += blocks[channel].square_sum;
+        }
+    }
+}
+
+rl_status_t rl_stats (const float * const data, const size_t data_length,
+                      rl_stats_t * const stats)
+{
+    return rl_stats_strided (data, data_length, 1U, stats);
+}
+
+rl_status_t rl_stats_strided (const float * const data, const size_t data_length,
+                              const size_t stride, rl_stats_t * const stats)
+{
+    channel_sums_t sums;
+
+    if (NULL == stats) { return RL_ERROR_NULL; }
+
+    stats_invalidate (stats);
+
+    if (NULL == data) { return RL_ERROR_NULL; }
+
+    if (0 == data_length || 0 == stride) { return RL_ERROR_DATA_LENGTH; }
+
+    channels_accumulate (data, data_length, stride, 1U, &sums);
+
+    if (!sums.finite) { return RL_ERROR_NO_DATA; }
+
+    channel_finish (&sums, data_length, stats);
+    return RL_SUCCESS;
+}
+
+rl_status_t rl_stats_interleaved (const float * const data, const size_t data_length,
+                                  const size_t stride, const size_t channels,
+                                  rl_stats_t * const stats)
+{
+    channel_sums_t sums[RL_STATS_MAX_CHANNELS];
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (NULL == stats) { return RL_ERROR_NULL; }
+
+    for (size_t channel = 0; (channel < channels) && (channel < RL_STATS_MAX_CHANNELS);
+            channel++)
+    {
+        stats_invalidate (&stats[channel]);
+    }
+
+    if (NULL == data) { return RL_ERROR_NULL; }
+
+    if (0 == data_length || 0 == channels || RL_STATS_MAX_CHANNELS < channels
+            || stride < channels)
+    {
+        return RL_ERROR_DATA_LENGTH;
+    }
+
+    channels_accumulate (data, data_length, stride, channels, sums);
+
+    for (size_t channel = 0; channel < channels; channel++)
+    {
+        if (sums[channel].finite)
+        {
+            channel_finish (&sums[channel], data_length, &stats[channel]);
+        }
+        else
+        {
+            err_code |= RL_ERROR_NO_DATA;
+        }
+    }
+
+    return err_code;
+}
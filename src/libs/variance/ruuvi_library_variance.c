@@ -1,6 +1,7 @@
 // See header file for copyright etc.
 
 #include "ruuvi_library_variance.h"
+#include "ruuvi_library_simd.h"
 #include <float.h>
 #include <math.h>
 
@@ -13,25 +14,74 @@ float rl_variance (const float * const data, const size_t data_length)
     float delta_sum = 0;
     float mean = 0;
 
-    // Calculate mean of values
-    for (size_t ii = 0; ii < data_length; ii++)
-    {
-        if (!isfinite (data[ii])) { return NAN; }
-
-        mean += data[ii];
-    }
+    // Calculate mean of values, finiteness is checked in same pass.
+    if (!rl_simd_sum (data, data_length, &mean)) { return NAN; }
 
     mean /= data_length;
-
     // Calculate squared differences
-    for (size_t ii = 0; ii < data_length; ii++)
-    {
-        delta_sum += powf (data[ii] - mean, 2);
-    }
+    delta_sum = rl_simd_deviation_square_sum (data, data_length, mean);
 
     // mean of differences
     if (!isfinite (delta_sum)) { return NAN; }
 
     rvalue = delta_sum / data_length;
     return rvalue;
-}
\ No newline at end of file
+}
+
+float rl_variance_i16 (const int16_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    int64_t sum = 0;
+    uint64_t square_sum = 0;
+    rl_simd_sum_i16 (data, data_length, &sum, &square_sum);
+    // n * variance = square_sum - sum^2 / n. With sum = q * n + r the large part
+    // square_sum - q * sum is exact in int64, only the small r * sum / n is rounded.
+    const int64_t count = (int64_t) data_length;
+    const int64_t quotient = sum / count;
+    const int64_t remainder = sum % count;
+    const double deviation = (double) ( (int64_t) square_sum - (quotient * sum))
+                             - ( ( (double) remainder * (double) sum) / (double) count);
+    return (deviation > 0.0) ? (float) (deviation / (double) count) : 0.0F;
+}
+
+float rl_variance_i32 (const int32_t * const data, const size_t data_length)
+{
+    if (NULL == data || 0 == data_length) { return NAN; }
+
+    // Shifting by first count keeps the sums small, so the subtraction does not cancel.
+    const int64_t shift = data[0];
+    int64_t sum = 0;
+    double square_sum = 0;
+
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        const int64_t delta = data[ii] - shift;
+        sum += delta;
+        square_sum += (double) delta * (double) delta;
+    }
+
+    const double mean = (double) sum / (double) data_length;
+    const double variance = (square_sum / (double) data_length) - (mean * mean);
+    return (variance > 0.0) ? (float) variance : 0.0F;
+}
+
+float rl_variance_strided (const float * const data, const size_t data_length,
+                           const size_t stride)
+{
+    if (NULL == data || 0 == data_length || 0 == stride) { return NAN; }
+
+    if (1U == stride) { return rl_variance (data, data_length); }
+
+    float mean = 0;
+
+    if (!rl_simd_sum_strided (data, data_length, stride, &mean)) { return NAN; }
+
+    mean /= data_length;
+    const float delta_sum = rl_simd_deviation_square_sum_strided (data, data_length, stride,
+                            mean);
+
+    if (!isfinite (delta_sum)) { return NAN; }
+
+    return delta_sum / data_length;
+}
@@ -13,7 +13,7 @@
 #include <stdint.h>
 
 
-#define RUUVI_LIBRARIES_SEMVER "3.0.0"
+#define RUUVI_LIBRARIES_SEMVER "3.1.0"
 
 #define RL_SUCCESS           (0U)        //!< Success
 #define RL_ERROR_INTERNAL    (1U << 0U)  //!< Unknown error, some failed assumption.
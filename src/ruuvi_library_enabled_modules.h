@@ -38,4 +38,19 @@
 #   define RL_LIBLZF_ENABLED 0
 #endif
 
+/** @brief Collect ringbuffer statistics, adds a few counters to every ringbuffer. */
+#ifndef RL_RINGBUFFER_STATS_ENABLED
+#   define RL_RINGBUFFER_STATS_ENABLED 0
+#endif
+
+/** @brief Compile file-backed ringbuffer, requires POSIX mmap. */
+#ifndef RL_RINGBUFFER_FILE_ENABLED
+#   define RL_RINGBUFFER_FILE_ENABLED 0
+#endif
+
+/** @brief Compile multi-threaded reductions, requires POSIX threads. */
+#ifndef RL_PARALLEL_ENABLED
+#   define RL_PARALLEL_ENABLED 0
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_fft.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LENGTH   (1024U)  //!< Longest transform tested.
+#define SAMPLE_RATE  (400.0F) //!< Sample rate of test signals, Hz.
+#define BENCH_ROUNDS (10000U) //!< Transforms timed in benchmark.
+
+static float twiddles[RL_FFT_TWIDDLES (MAX_LENGTH)];
+static float samples[MAX_LENGTH];
+static float spectrum[MAX_LENGTH];
+static double expected[MAX_LENGTH + 2U];
+
+void setUp (void)
+{
+    uint32_t state = 2020U;
+
+    for (size_t ii = 0; ii < MAX_LENGTH; ii++)
+    {
+        state = (state * 1664525U) + 1013904223U;
+        samples[ii] = 1.0F + ( (float) (state >> 8) / 16777216.0F) - 0.5F;
+    }
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * @brief Reference DFT in double, bins 0 ... length / 2 as real and imaginary pairs.
+ */
+static void dft (const float * const data, const size_t length)
+{
+    for (size_t kk = 0; kk <= (length / 2U); kk++)
+    {
+        double real = 0.0;
+        double imag = 0.0;
+
+        for (size_t nn = 0; nn < length; nn++)
+        {
+            const double angle = -2.0 * 3.14159265358979323846 * (double) ( (kk * nn) % length)
+                                 / (double) length;
+            real += data[nn] * cos (angle);
+            imag += data[nn] * sin (angle);
+        }
+
+        expected[2U * kk] = real;
+        expected[ (2U * kk) + 1U] = imag;
+    }
+}
+
+static void sine_fill (const size_t length, const float frequency, const float amplitude)
+{
+    for (size_t ii = 0; ii < length; ii++)
+    {
+        samples[ii] = 0.5F + (amplitude * sinf (2.0F * 3.14159265F * frequency * ii
+                                                 / SAMPLE_RATE));
+    }
+}
+
+void test_ruuvi_library_fft_matches_dft (void)
+{
+    for (size_t length = 4U; length <= MAX_LENGTH; length *= 2U)
+    {
+        const rl_fft_t fft = {.length = length, .twiddles = twiddles};
+        // Float rounding grows with log2 of length, relative to norm of input.
+        const double tolerance = 8.0 * FLT_EPSILON * log2 ( (double) length)
+                                 * (double) length * rl_rms (samples, length);
+        TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+        dft (samples, length);
+        memcpy (spectrum, samples, length * sizeof (samples[0]));
+        TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, spectrum));
+        TEST_ASSERT (fabs (spectrum[0] - expected[0]) <= tolerance);
+        TEST_ASSERT (fabs (spectrum[1] - expected[length]) <= tolerance);
+        TEST_ASSERT (fabs (expected[length + 1U]) <= tolerance);
+
+        for (size_t kk = 1U; kk < (length / 2U); kk++)
+        {
+            TEST_ASSERT (fabs (spectrum[2U * kk] - expected[2U * kk]) <= tolerance);
+            TEST_ASSERT (fabs (spectrum[ (2U * kk) + 1U] - expected[ (2U * kk) + 1U])
+                         <= tolerance);
+        }
+    }
+}
+
+void test_ruuvi_library_fft_power_parseval (void)
+{
+    const rl_fft_t fft = {.length = MAX_LENGTH, .twiddles = twiddles};
+    const float rms = rl_rms (samples, MAX_LENGTH);
+    double total = 0.0;
+    TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+    memcpy (spectrum, samples, sizeof (samples));
+    TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, spectrum));
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F * rms * rms, rms * rms,
+                              rl_fft_band_energy (spectrum, MAX_LENGTH, SAMPLE_RATE,
+                                      0.0F, INFINITY));
+    // DC only is square of mean, power spectrum in place.
+    const float dc = rl_fft_band_energy (spectrum, MAX_LENGTH, SAMPLE_RATE, 0.0F, 0.1F);
+    TEST_ASSERT (RL_SUCCESS == rl_fft_power (spectrum, MAX_LENGTH, spectrum));
+    TEST_ASSERT_EQUAL_FLOAT (dc, spectrum[0]);
+
+    for (size_t kk = 0; kk <= (MAX_LENGTH / 2U); kk++)
+    {
+        total += spectrum[kk];
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F * rms * rms, rms * rms, (float) total);
+}
+
+void test_ruuvi_library_fft_band_energy (void)
+{
+    const rl_fft_t fft = {.length = MAX_LENGTH, .twiddles = twiddles};
+    // Tone at bin 128, 50 Hz.
+    sine_fill (MAX_LENGTH, 50.0F, 2.0F);
+    TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+    TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, samples));
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F, 2.0F,
+                              rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 40.0F, 60.0F));
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F, 0.25F,
+                              rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 0.0F, 10.0F));
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F, 0.0F,
+                              rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 60.0F, 200.0F));
+    // Band edges are half open, tone is counted once.
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F, 2.0F,
+                              rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 50.0F, 60.0F));
+    TEST_ASSERT_FLOAT_WITHIN (1e-4F, 0.0F,
+                              rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 40.0F, 50.0F));
+}
+
+void test_ruuvi_library_fft_dominant_frequency (void)
+{
+    const rl_fft_t fft = {.length = MAX_LENGTH, .twiddles = twiddles};
+    const float bin_width = SAMPLE_RATE / MAX_LENGTH;
+    const float frequencies[] = {50.0F, 23.4F, 101.7F, 180.1F};
+    TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+
+    for (size_t ii = 0; ii < (sizeof (frequencies) / sizeof (frequencies[0])); ii++)
+    {
+        sine_fill (MAX_LENGTH, frequencies[ii], 0.1F);
+        TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, samples));
+        const float found = rl_fft_dominant_frequency (samples, MAX_LENGTH, SAMPLE_RATE);
+        TEST_ASSERT_FLOAT_WITHIN (0.25F * bin_width, frequencies[ii], found);
+    }
+}
+
+void test_ruuvi_library_fft_nan_input (void)
+{
+    const rl_fft_t fft = {.length = MAX_LENGTH, .twiddles = twiddles};
+    TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+    samples[10] = NAN;
+    TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, samples));
+    TEST_ASSERT (isnan (rl_fft_band_energy (samples, MAX_LENGTH, SAMPLE_RATE, 0.0F, 1.0F)));
+    TEST_ASSERT (isnan (rl_fft_dominant_frequency (samples, MAX_LENGTH, SAMPLE_RATE)));
+}
+
+void test_ruuvi_library_fft_no_power (void)
+{
+    const float dc_only[4] = {4.0F, 0.0F, 0.0F, 0.0F};
+    TEST_ASSERT (isnan (rl_fft_dominant_frequency (dc_only, 4, SAMPLE_RATE)));
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, rl_fft_band_energy (dc_only, 4, SAMPLE_RATE, 0.0F,
+                             INFINITY));
+}
+
+void test_ruuvi_library_fft_input_check (void)
+{
+    const rl_fft_t no_twiddles = {.length = 8, .twiddles = NULL};
+    const rl_fft_t too_short = {.length = 2, .twiddles = twiddles};
+    const rl_fft_t not_power = {.length = 24, .twiddles = twiddles};
+    const rl_fft_t valid = {.length = 8, .twiddles = twiddles};
+    TEST_ASSERT (RL_ERROR_NULL == rl_fft_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_fft_init (&no_twiddles));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_fft_init (&too_short));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_fft_init (&not_power));
+    TEST_ASSERT (RL_ERROR_NULL == rl_fft_real (&valid, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_fft_real (NULL, samples));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_fft_real (&too_short, samples));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_fft_real (&not_power, samples));
+    TEST_ASSERT (RL_ERROR_NULL == rl_fft_power (NULL, 8, spectrum));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_fft_power (samples, 12, spectrum));
+    TEST_ASSERT (isnan (rl_fft_band_energy (NULL, 8, SAMPLE_RATE, 0.0F, 1.0F)));
+    TEST_ASSERT (isnan (rl_fft_band_energy (samples, 8, 0.0F, 0.0F, 1.0F)));
+    TEST_ASSERT (isnan (rl_fft_band_energy (samples, 8, SAMPLE_RATE, 2.0F, 1.0F)));
+    TEST_ASSERT (isnan (rl_fft_band_energy (samples, 8, SAMPLE_RATE, NAN, 1.0F)));
+    TEST_ASSERT (isnan (rl_fft_dominant_frequency (samples, 6, SAMPLE_RATE)));
+    TEST_ASSERT (isnan (rl_fft_dominant_frequency (samples, 8, -1.0F)));
+}
+
+void test_ruuvi_library_fft_speed (void)
+{
+    const rl_fft_t fft = {.length = MAX_LENGTH, .twiddles = twiddles};
+    struct timespec start;
+    struct timespec end;
+    TEST_ASSERT (RL_SUCCESS == rl_fft_init (&fft));
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    for (size_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        memcpy (spectrum, samples, sizeof (samples));
+        TEST_ASSERT (RL_SUCCESS == rl_fft_real (&fft, spectrum));
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &end);
+    const double elapsed = (end.tv_sec - start.tv_sec)
+                           + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+    printf ("%u point real FFT: %.2f us\n", MAX_LENGTH, elapsed / BENCH_ROUNDS * 1e6);
+    TEST_ASSERT (1e-3 > (elapsed / BENCH_ROUNDS));
+}
@@ -0,0 +1,140 @@
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_moments.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_stats.h"
+#include "ruuvi_library_variance.h"
+
+#include <math.h>
+
+#define LENGTH (5000U) //!< Samples in comparison vector.
+#define STREAM_LENGTH (2000000U) //!< Samples in long stream test.
+
+static float vector[LENGTH];
+static rl_moments_t moments;
+
+void setUp (void)
+{
+    rl_moments_init (&moments);
+
+    for (size_t ii = 0; ii < LENGTH; ii++)
+    {
+        vector[ii] = 1000.0F + (30.0F * sinf (ii * 0.05F)) + (float) ( (ii * 7919U) % 11U);
+    }
+}
+
+void tearDown (void)
+{
+}
+
+static void assert_matches_batch (const rl_stats_t * const stats, const float * const data,
+                                  const size_t length)
+{
+    rl_stats_t expected;
+    TEST_ASSERT (RL_SUCCESS == rl_stats (data, length, &expected));
+    TEST_ASSERT_EQUAL_FLOAT (expected.mean, stats->mean);
+    TEST_ASSERT_FLOAT_WITHIN (expected.variance * 1e-4F, rl_variance (data, length),
+                              stats->variance);
+    TEST_ASSERT_EQUAL_FLOAT (rl_rms (data, length), stats->rms);
+    TEST_ASSERT (expected.min == stats->min);
+    TEST_ASSERT (expected.max == stats->max);
+    TEST_ASSERT (expected.peak2peak == stats->peak2peak);
+}
+
+void test_ruuvi_library_moments_push (void)
+{
+    rl_stats_t stats;
+
+    for (size_t ii = 0; ii < LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_moments_push (&moments, vector[ii]));
+    }
+
+    TEST_ASSERT (RL_SUCCESS == rl_moments_finalize (&moments, &stats));
+    TEST_ASSERT (LENGTH == moments.count);
+    assert_matches_batch (&stats, vector, LENGTH);
+}
+
+void test_ruuvi_library_moments_push_n (void)
+{
+    rl_stats_t stats;
+    // Uneven blocks, including an empty one.
+    TEST_ASSERT (RL_SUCCESS == rl_moments_push_n (&moments, vector, 3));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_push_n (&moments, &vector[3], 0));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_push_n (&moments, &vector[3], LENGTH - 3));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_finalize (&moments, &stats));
+    assert_matches_batch (&stats, vector, LENGTH);
+}
+
+void test_ruuvi_library_moments_merge (void)
+{
+    rl_moments_t parts[3];
+    rl_stats_t stats;
+    const size_t split[4] = {0, 1, 2700, LENGTH};
+
+    for (size_t ii = 0; ii < 3; ii++)
+    {
+        rl_moments_init (&parts[ii]);
+        rl_moments_push_n (&parts[ii], &vector[split[ii]], split[ii + 1] - split[ii]);
+    }
+
+    // Merging an empty accumulator changes nothing.
+    rl_moments_t empty;
+    rl_moments_init (&empty);
+    TEST_ASSERT (RL_SUCCESS == rl_moments_merge (&moments, &empty));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_merge (&moments, &parts[2]));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_merge (&moments, &parts[0]));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_merge (&moments, &parts[1]));
+    TEST_ASSERT (RL_SUCCESS == rl_moments_finalize (&moments, &stats));
+    TEST_ASSERT (LENGTH == moments.count);
+    assert_matches_batch (&stats, vector, LENGTH);
+}
+
+void test_ruuvi_library_moments_long_stream (void)
+{
+    rl_stats_t stats;
+
+    // Alternating 100000 +- 1, exact variance 1 and mean 100000.
+    for (uint32_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        rl_moments_push (&moments, (ii & 1U) ? 100001.0F : 99999.0F);
+    }
+
+    TEST_ASSERT (RL_SUCCESS == rl_moments_finalize (&moments, &stats));
+    TEST_ASSERT_EQUAL_FLOAT (100000.0F, stats.mean);
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, stats.variance);
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, stats.peak2peak);
+}
+
+void test_ruuvi_library_moments_nan (void)
+{
+    rl_stats_t stats;
+    rl_moments_t poisoned;
+    const float nan_vector[] = {1.0F, NAN, 2.0F};
+    rl_moments_init (&poisoned);
+    TEST_ASSERT (RL_SUCCESS == rl_moments_push_n (&poisoned, nan_vector, 3));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_moments_finalize (&poisoned, &stats));
+    TEST_ASSERT (isnan (stats.rms));
+    rl_moments_push_n (&moments, vector, LENGTH);
+    TEST_ASSERT (RL_SUCCESS == rl_moments_merge (&moments, &poisoned));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_moments_finalize (&moments, &stats));
+    TEST_ASSERT (isnan (stats.mean));
+    rl_moments_init (&moments);
+    TEST_ASSERT (RL_SUCCESS == rl_moments_push (&moments, INFINITY));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_moments_finalize (&moments, &stats));
+}
+
+void test_ruuvi_library_moments_input_check (void)
+{
+    rl_stats_t stats;
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_moments_finalize (&moments, &stats));
+    TEST_ASSERT (isnan (stats.variance));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_push (NULL, 1.0F));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_push_n (&moments, NULL, 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_merge (&moments, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_finalize (NULL, &stats));
+    TEST_ASSERT (RL_ERROR_NULL == rl_moments_finalize (&moments, NULL));
+}
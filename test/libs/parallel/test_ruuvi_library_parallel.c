@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_enabled_modules.h"
+#include "ruuvi_library_moments.h"
+#include "ruuvi_library_parallel.h"
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_stats.h"
+#include "ruuvi_library_variance.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define LENGTH       (100003U)  //!< Samples in comparison vector, not divisible by parts.
+#define BENCH_LENGTH (8000000U) //!< Samples in benchmark vector.
+#define BENCH_ROUNDS (5U)       //!< Reductions timed per worker count.
+#define WORKERS      (3U)       //!< Workers in comparison tests.
+
+static float vector[LENGTH];
+#if RL_PARALLEL_ENABLED
+static float bench_vector[BENCH_LENGTH];
+static rl_parallel_pool_t pool;
+#endif
+
+void setUp (void)
+{
+    for (size_t ii = 0; ii < LENGTH; ii++)
+    {
+        vector[ii] = 101325.0F + (25.0F * sinf (ii * 0.001F)) + (float) ( (ii * 7919U) % 13U);
+    }
+
+#if RL_PARALLEL_ENABLED
+    rl_parallel_init (&pool, WORKERS);
+#endif
+}
+
+void tearDown (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_parallel_uninit (&pool);
+#endif
+}
+
+#if RL_PARALLEL_ENABLED
+static void count_task (void * const context, const size_t part, const size_t parts)
+{
+    size_t * const counts = (size_t *) context;
+    counts[part] += parts;
+}
+#endif
+
+void test_ruuvi_library_parallel_run (void)
+{
+#if RL_PARALLEL_ENABLED
+    size_t counts[WORKERS + 1] = {0};
+
+    for (size_t round = 0; round < 100; round++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_parallel_run (&pool, &count_task, counts));
+    }
+
+    // Every part ran exactly once per round.
+    for (size_t ii = 0; ii <= WORKERS; ii++)
+    {
+        TEST_ASSERT_EQUAL (100U * (WORKERS + 1U), counts[ii]);
+    }
+
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_matches_serial (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_stats_t stats;
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_stats (&pool, vector, LENGTH, &stats));
+    const float rms = rl_rms (vector, LENGTH);
+    const float variance = rl_variance (vector, LENGTH);
+    TEST_ASSERT_FLOAT_WITHIN (LENGTH * FLT_EPSILON * rms, rms, stats.rms);
+    TEST_ASSERT_FLOAT_WITHIN (LENGTH * FLT_EPSILON * variance, variance, stats.variance);
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (vector, LENGTH), stats.peak2peak);
+    TEST_ASSERT_EQUAL_FLOAT (stats.rms, rl_parallel_rms (&pool, vector, LENGTH));
+    TEST_ASSERT_EQUAL_FLOAT (stats.variance, rl_parallel_variance (&pool, vector, LENGTH));
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_matches_moments (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_moments_t serial;
+    rl_moments_t parallel;
+    rl_moments_init (&serial);
+    rl_moments_init (&parallel);
+    rl_moments_push_n (&serial, vector, LENGTH);
+    // Blocks are summed in float, partials differ from serial by block rounding.
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_moments (&pool, vector, LENGTH, &parallel));
+    TEST_ASSERT (serial.count == parallel.count);
+    TEST_ASSERT (serial.min == parallel.min);
+    TEST_ASSERT (serial.max == parallel.max);
+    TEST_ASSERT (fabs (serial.mean - parallel.mean) <= (FLT_EPSILON * serial.mean));
+    TEST_ASSERT (fabs (serial.m2 - parallel.m2) <= (1e-3 * serial.m2));
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_no_workers (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_parallel_pool_t single;
+    rl_stats_t stats;
+    rl_stats_t expected;
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_init (&single, 0));
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_stats (&single, vector, LENGTH, &stats));
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_stats (&pool, vector, LENGTH, &expected));
+    TEST_ASSERT_FLOAT_WITHIN (1e-6F * expected.rms, expected.rms, stats.rms);
+    TEST_ASSERT_EQUAL_FLOAT (expected.peak2peak, stats.peak2peak);
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_uninit (&single));
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_short (void)
+{
+#if RL_PARALLEL_ENABLED
+    // Fewer samples than parts, some parts are empty.
+    const float valid_test_vector[] = {0.0F, 1.0F, -1.0F};
+    rl_stats_t stats;
+    TEST_ASSERT (RL_SUCCESS == rl_parallel_stats (&pool, valid_test_vector, 3, &stats));
+    TEST_ASSERT_EQUAL_FLOAT (rl_rms (valid_test_vector, 3), stats.rms);
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, stats.peak2peak);
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, stats.mean);
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_nan_input (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_stats_t stats;
+    vector[LENGTH / 2] = NAN;
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_parallel_stats (&pool, vector, LENGTH, &stats));
+    TEST_ASSERT (isnan (stats.mean));
+    TEST_ASSERT (isnan (stats.peak2peak));
+    TEST_ASSERT (isnan (rl_parallel_rms (&pool, vector, LENGTH)));
+    vector[LENGTH / 2] = INFINITY;
+    TEST_ASSERT (isnan (rl_parallel_variance (&pool, vector, LENGTH)));
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_input_check (void)
+{
+#if RL_PARALLEL_ENABLED
+    rl_parallel_pool_t too_many;
+    rl_moments_t moments;
+    rl_stats_t stats;
+    rl_moments_init (&moments);
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_init (NULL, 1));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_parallel_init (&too_many,
+                 RL_PARALLEL_MAX_WORKERS + 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_uninit (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_run (&pool, NULL, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_moments (&pool, NULL, 5, &moments));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_moments (&pool, vector, 5, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_stats (&pool, vector, 5, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_parallel_stats (NULL, vector, 5, &stats));
+    TEST_ASSERT (isnan (stats.rms));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_parallel_stats (&pool, vector, 0, &stats));
+    TEST_ASSERT (isnan (stats.rms));
+    TEST_ASSERT (isnan (rl_parallel_rms (&pool, NULL, 5)));
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_parallel_scaling (void)
+{
+#if RL_PARALLEL_ENABLED
+    const size_t worker_counts[] = {0, 1, 3, 7};
+
+    for (size_t ii = 0; ii < BENCH_LENGTH; ii++)
+    {
+        bench_vector[ii] = vector[ii % LENGTH];
+    }
+
+    for (size_t ii = 0; ii < (sizeof (worker_counts) / sizeof (worker_counts[0])); ii++)
+    {
+        rl_parallel_pool_t bench_pool;
+        rl_stats_t stats;
+        struct timespec start;
+        struct timespec end;
+        TEST_ASSERT (RL_SUCCESS == rl_parallel_init (&bench_pool, worker_counts[ii]));
+        clock_gettime (CLOCK_MONOTONIC, &start);
+
+        for (size_t round = 0; round < BENCH_ROUNDS; round++)
+        {
+            TEST_ASSERT (RL_SUCCESS == rl_parallel_stats (&bench_pool, bench_vector,
+                         BENCH_LENGTH, &stats));
+        }
+
+        clock_gettime (CLOCK_MONOTONIC, &end);
+        TEST_ASSERT (RL_SUCCESS == rl_parallel_uninit (&bench_pool));
+        const double elapsed = (end.tv_sec - start.tv_sec)
+                               + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+        printf ("%zu workers: %.1f M samples / s\n", worker_counts[ii],
+                ( (double) BENCH_LENGTH * BENCH_ROUNDS / elapsed) / 1e6);
+    }
+
+#else
+    TEST_IGNORE_MESSAGE ("RL_PARALLEL_ENABLED is 0");
+#endif
+}
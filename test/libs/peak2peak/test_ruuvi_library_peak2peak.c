@@ -0,0 +1,168 @@
+#include "unity.h"
+
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_simd.h"
+
+#include <math.h>
+#include <stdint.h>
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+const float valid_test_vector[] = {0.0F, 1.0F, -1.0F, 50.0F, 25.0F};
+const int16_t valid_i16_vector[] = {0, 1, -1, 50, 25};
+const int32_t valid_i32_vector[] = {0, 1, -1, 50, 25};
+
+void test_ruuvi_library_peak2peak_integer_ok (void)
+{
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (valid_test_vector, 5),
+                             rl_peak2peak_i16 (valid_i16_vector, 5));
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (valid_test_vector, 5),
+                             rl_peak2peak_i32 (valid_i32_vector, 5));
+}
+
+void test_ruuvi_library_peak2peak_integer_negative (void)
+{
+    const int16_t negative[] = {-3, -1, -2};
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, rl_peak2peak_i16 (negative, 3));
+}
+
+void test_ruuvi_library_peak2peak_integer_full_scale (void)
+{
+    const int16_t i16_extremes[] = {0, INT16_MAX, INT16_MIN};
+    const int32_t i32_extremes[] = {0, INT32_MAX, INT32_MIN};
+    TEST_ASSERT_EQUAL_FLOAT (65535.0F, rl_peak2peak_i16 (i16_extremes, 3));
+    TEST_ASSERT_EQUAL_FLOAT (4294967295.0F, rl_peak2peak_i32 (i32_extremes, 3));
+}
+
+void test_ruuvi_library_peak2peak_integer_invalid (void)
+{
+    TEST_ASSERT (isnan (rl_peak2peak_i16 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_peak2peak_i16 (valid_i16_vector, 0)));
+    TEST_ASSERT (isnan (rl_peak2peak_i32 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_peak2peak_i32 (valid_i32_vector, 0)));
+}
+
+void test_ruuvi_library_peak2peak_strided (void)
+{
+    const float interleaved[] = {0.0F, NAN, 1.0F, NAN, -1.0F, NAN, 50.0F, NAN, 25.0F};
+    TEST_ASSERT_EQUAL_FLOAT (51.0F, rl_peak2peak_strided (interleaved, 5, 2));
+    TEST_ASSERT (isnan (rl_peak2peak_strided (&interleaved[1], 4, 2)));
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (valid_test_vector, 5),
+                             rl_peak2peak_strided (valid_test_vector, 5, 1));
+    TEST_ASSERT (isnan (rl_peak2peak_strided (valid_test_vector, 5, 0)));
+    TEST_ASSERT (isnan (rl_peak2peak_strided (NULL, 5, 2)));
+}
+
+#define WINDOW_LENGTH (50U)   //!< Samples in full window.
+#define STREAM_LENGTH (1000U) //!< Samples pushed in comparison tests.
+
+static rl_peak2peak_extremum_t mins[WINDOW_LENGTH];
+static rl_peak2peak_extremum_t maxs[WINDOW_LENGTH];
+
+static void window_matches (rl_peak2peak_window_t * const window,
+                            const float * const stream)
+{
+    TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_init (window));
+
+    for (size_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_push (window, stream[ii]));
+        const size_t count = (ii < window->length) ? ii + 1 : window->length;
+        const float expected = rl_peak2peak (&stream[ii + 1 - count], count);
+
+        if (isnan (expected))
+        {
+            TEST_ASSERT (isnan (rl_peak2peak_window_value (window)));
+        }
+        else
+        {
+            TEST_ASSERT (expected == rl_peak2peak_window_value (window));
+        }
+    }
+}
+
+void test_ruuvi_library_peak2peak_window_matches (void)
+{
+    static float stream[STREAM_LENGTH];
+    rl_peak2peak_window_t window =
+    {
+        .length = WINDOW_LENGTH,
+        .min = {.items = mins},
+        .max = {.items = maxs}
+    };
+
+    // Noise, steps and monotonic runs so that every sample is an extremum in turn.
+    for (size_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        const float ramp = ( (ii % 300U) < 100U) ? (float) ii : 0.0F;
+        stream[ii] = (10.0F * sinf (ii * 0.1F)) + (float) ( (ii * 7919U) % 13U)
+                     + (float) ( (ii / 200U) * 50U) - ramp;
+    }
+
+    window_matches (&window, stream);
+    stream[500] = NAN;
+    stream[700] = INFINITY;
+    window_matches (&window, stream);
+}
+
+void test_ruuvi_library_peak2peak_window_length_one (void)
+{
+    rl_peak2peak_window_t window =
+    {
+        .length = 1,
+        .min = {.items = mins},
+        .max = {.items = maxs}
+    };
+    TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_init (&window));
+    TEST_ASSERT (isnan (rl_peak2peak_window_value (&window)));
+    TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_push (&window, 5.0F));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_peak2peak_window_value (&window));
+    TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_push (&window, -5.0F));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_peak2peak_window_value (&window));
+}
+
+void test_ruuvi_library_peak2peak_window_sequence_wrap (void)
+{
+    rl_peak2peak_window_t window =
+    {
+        .length = WINDOW_LENGTH,
+        .min = {.items = mins},
+        .max = {.items = maxs}
+    };
+    TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_init (&window));
+    window.sequence = UINT32_MAX - 10U;
+
+    for (size_t ii = 0; ii < 3U * WINDOW_LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_peak2peak_window_push (&window, (float) ii));
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT (WINDOW_LENGTH - 1, rl_peak2peak_window_value (&window));
+}
+
+void test_ruuvi_library_peak2peak_window_invalid (void)
+{
+    rl_peak2peak_window_t empty =
+    {
+        .length = 0,
+        .min = {.items = mins},
+        .max = {.items = maxs}
+    };
+    rl_peak2peak_window_t no_deque =
+    {
+        .length = WINDOW_LENGTH,
+        .min = {.items = NULL},
+        .max = {.items = maxs}
+    };
+    TEST_ASSERT (RL_ERROR_NULL == rl_peak2peak_window_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_peak2peak_window_init (&no_deque));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_peak2peak_window_init (&empty));
+    TEST_ASSERT (RL_ERROR_NULL == rl_peak2peak_window_push (NULL, 1.0F));
+    TEST_ASSERT (isnan (rl_peak2peak_window_value (NULL)));
+}
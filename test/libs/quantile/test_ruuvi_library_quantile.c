@@ -0,0 +1,198 @@
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_quantile.h"
+
+#include <math.h>
+#include <string.h>
+
+#define STREAM_LENGTH (100000U) //!< Samples in accuracy tests.
+
+static rl_quantile_t quantile;
+static float stream[STREAM_LENGTH];
+static float sorted[STREAM_LENGTH];
+
+void setUp (void)
+{
+    rl_quantile_init (&quantile);
+}
+
+void tearDown (void)
+{
+}
+
+static int float_compare (const void * a, const void * b)
+{
+    const float left = * (const float *) a;
+    const float right = * (const float *) b;
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Exact quantile with the same interpolation between ranks k - 0.5.
+ */
+static float exact_quantile (const float * const values, const size_t length, const float q)
+{
+    const double position = ( (double) q * length) - 0.5;
+
+    if (position <= 0.0) { return values[0]; }
+
+    if (position >= (length - 1.0)) { return values[length - 1]; }
+
+    const size_t index = (size_t) position;
+    const double fraction = position - index;
+    return (float) (values[index] + ( (values[index + 1] - values[index]) * fraction));
+}
+
+/**
+ * @brief Fraction of sorted samples below value.
+ */
+static double rank_of (const float value)
+{
+    size_t low = 0;
+    size_t high = STREAM_LENGTH;
+
+    while (low < high)
+    {
+        const size_t middle = (low + high) / 2;
+
+        if (sorted[middle] < value) { low = middle + 1; }
+        else { high = middle; }
+    }
+
+    return (double) low / STREAM_LENGTH;
+}
+
+/**
+ * @brief Vibration-like amplitudes: mostly small with a long tail.
+ */
+static void stream_fill (void)
+{
+    uint32_t state = 12345U;
+
+    for (size_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        state = (state * 1664525U) + 1013904223U;
+        const float uniform = ( (float) (state >> 8) + 0.5F) / 16777216.0F;
+        stream[ii] = -logf (uniform) * (1.0F + (0.5F * sinf (ii * 0.001F)));
+    }
+
+    memcpy (sorted, stream, sizeof (stream));
+    qsort (sorted, STREAM_LENGTH, sizeof (sorted[0]), &float_compare);
+}
+
+void test_ruuvi_library_quantile_exact_small (void)
+{
+    const float values[] = {5.0F, 1.0F, 4.0F, 2.0F, 3.0F, 9.0F};
+    const float ascending[] = {1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 9.0F};
+    const float qs[] = {0.0F, 0.1F, 0.25F, 0.5F, 0.75F, 0.95F, 1.0F};
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push_n (&quantile, values, 6));
+
+    for (size_t ii = 0; ii < (sizeof (qs) / sizeof (qs[0])); ii++)
+    {
+        TEST_ASSERT_EQUAL_FLOAT (exact_quantile (ascending, 6, qs[ii]),
+                                 rl_quantile_value (&quantile, qs[ii]));
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT (3.5F, rl_quantile_value (&quantile, 0.5F));
+}
+
+void test_ruuvi_library_quantile_exact_until_full (void)
+{
+    const size_t length = RL_QUANTILE_CENTROIDS;
+    stream_fill();
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push_n (&quantile, stream, length));
+    memcpy (sorted, stream, length * sizeof (stream[0]));
+    qsort (sorted, length, sizeof (sorted[0]), &float_compare);
+
+    for (float q = 0.0F; q <= 1.0F; q += 0.05F)
+    {
+        TEST_ASSERT_EQUAL_FLOAT (exact_quantile (sorted, length, q),
+                                 rl_quantile_value (&quantile, q));
+    }
+}
+
+void test_ruuvi_library_quantile_accuracy (void)
+{
+    const float qs[] = {0.01F, 0.1F, 0.5F, 0.9F, 0.95F, 0.99F, 0.999F};
+    stream_fill();
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push_n (&quantile, stream, STREAM_LENGTH));
+    TEST_ASSERT_EQUAL_FLOAT (sorted[0], rl_quantile_value (&quantile, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT (sorted[STREAM_LENGTH - 1], rl_quantile_value (&quantile, 1.0F));
+
+    for (size_t ii = 0; ii < (sizeof (qs) / sizeof (qs[0])); ii++)
+    {
+        const double error = fabs (rank_of (rl_quantile_value (&quantile, qs[ii])) - qs[ii]);
+        // Documented bound: 0.5 % overall, 0.2 % in the tails.
+        TEST_ASSERT (error < ( (qs[ii] < 0.05F || qs[ii] > 0.95F) ? 0.002 : 0.005));
+    }
+
+    TEST_ASSERT (quantile.compressed <= RL_QUANTILE_CENTROIDS);
+}
+
+void test_ruuvi_library_quantile_merge (void)
+{
+    rl_quantile_t parts[4];
+    stream_fill();
+
+    for (size_t part = 0; part < 4; part++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_quantile_init (&parts[part]));
+        TEST_ASSERT (RL_SUCCESS == rl_quantile_push_n (&parts[part],
+                     &stream[part * (STREAM_LENGTH / 4)], STREAM_LENGTH / 4));
+        TEST_ASSERT (RL_SUCCESS == rl_quantile_merge (&quantile, &parts[part]));
+    }
+
+    TEST_ASSERT (STREAM_LENGTH == quantile.count);
+    TEST_ASSERT_EQUAL_FLOAT (sorted[0], rl_quantile_value (&quantile, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT (sorted[STREAM_LENGTH - 1], rl_quantile_value (&quantile, 1.0F));
+    TEST_ASSERT (fabs (rank_of (rl_quantile_value (&quantile, 0.5F)) - 0.5) < 0.01);
+    TEST_ASSERT (fabs (rank_of (rl_quantile_value (&quantile, 0.95F)) - 0.95) < 0.005);
+}
+
+void test_ruuvi_library_quantile_merge_empty (void)
+{
+    rl_quantile_t other;
+    rl_quantile_init (&other);
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_merge (&quantile, &other));
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, 0.5F)));
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push (&other, 2.0F));
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_merge (&quantile, &other));
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, rl_quantile_value (&quantile, 0.5F));
+}
+
+void test_ruuvi_library_quantile_merge_self (void)
+{
+    stream_fill();
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push_n (&quantile, stream, STREAM_LENGTH));
+    const float median = rl_quantile_value (&quantile, 0.5F);
+    const float p99 = rl_quantile_value (&quantile, 0.99F);
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_merge (&quantile, &quantile));
+    TEST_ASSERT ( (2U * STREAM_LENGTH) == quantile.count);
+    TEST_ASSERT (quantile.compressed <= RL_QUANTILE_CENTROIDS);
+    TEST_ASSERT_EQUAL_FLOAT (sorted[0], rl_quantile_value (&quantile, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT (sorted[STREAM_LENGTH - 1], rl_quantile_value (&quantile, 1.0F));
+    TEST_ASSERT_EQUAL_FLOAT (median, rl_quantile_value (&quantile, 0.5F));
+    TEST_ASSERT_EQUAL_FLOAT (p99, rl_quantile_value (&quantile, 0.99F));
+}
+
+void test_ruuvi_library_quantile_nan_input (void)
+{
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push (&quantile, 1.0F));
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push (&quantile, NAN));
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, 0.5F)));
+}
+
+void test_ruuvi_library_quantile_input_check (void)
+{
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, 0.5F)));
+    TEST_ASSERT (RL_SUCCESS == rl_quantile_push (&quantile, 1.0F));
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, -0.1F)));
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, 1.1F)));
+    TEST_ASSERT (isnan (rl_quantile_value (&quantile, NAN)));
+    TEST_ASSERT (isnan (rl_quantile_value (NULL, 0.5F)));
+    TEST_ASSERT (RL_ERROR_NULL == rl_quantile_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_quantile_push (NULL, 1.0F));
+    TEST_ASSERT (RL_ERROR_NULL == rl_quantile_push_n (&quantile, NULL, 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_quantile_merge (&quantile, NULL));
+}
@@ -0,0 +1,206 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_bipbuffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define STRESS_RECORDS (200000U) //!< Number of records pushed through buffer in stress test.
+
+static uint32_t buffer_data[64] = {0};
+static rl_bipbuffer_t bipbuf =
+{
+    .storage_size = sizeof (buffer_data),
+    .storage = buffer_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL
+};
+
+void setUp (void)
+{
+    memset (buffer_data, 0, sizeof (buffer_data));
+    rl_bipbuffer_init (&bipbuf);
+}
+
+void tearDown (void)
+{
+}
+
+void test_ruuvi_library_bipbuffer_queue_dequeue (void)
+{
+    const uint8_t event[3] = {1, 2, 3};
+    uint8_t payload[64] = {0};
+    uint8_t * p_readback = NULL;
+    size_t length = 0;
+
+    for (size_t ii = 0; ii < sizeof (payload); ii++)
+    {
+        payload[ii] = ii;
+    }
+
+    TEST_ASSERT (rl_bipbuffer_empty (&bipbuf));
+    rl_status_t lib_status = rl_bipbuffer_queue (&bipbuf, event, sizeof (event));
+    lib_status |= rl_bipbuffer_queue (&bipbuf, payload, sizeof (payload));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (!rl_bipbuffer_empty (&bipbuf));
+    lib_status |= rl_bipbuffer_peek (&bipbuf, &p_readback, &length);
+    TEST_ASSERT (sizeof (event) == length);
+    lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+    TEST_ASSERT (sizeof (event) == length);
+    TEST_ASSERT (!memcmp (event, p_readback, length));
+    lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (sizeof (payload) == length);
+    TEST_ASSERT (!memcmp (payload, p_readback, length));
+    TEST_ASSERT (rl_bipbuffer_empty (&bipbuf));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length));
+}
+
+void test_ruuvi_library_bipbuffer_small_records_pack (void)
+{
+    const uint32_t event = 0xAABBCCDDU;
+    size_t queued = 0;
+
+    while (RL_SUCCESS == rl_bipbuffer_queue (&bipbuf, &event, sizeof (event)))
+    {
+        queued++;
+    }
+
+    // 4-byte events take 8 bytes each instead of a slot sized for the largest record.
+    TEST_ASSERT ( (sizeof (buffer_data) / RL_BIPBUFFER_RECORD_SIZE (sizeof (event)))
+                  == queued);
+}
+
+void test_ruuvi_library_bipbuffer_wrap_is_contiguous (void)
+{
+    uint8_t payload[100] = {0};
+    uint8_t * p_readback = NULL;
+    size_t length = 0;
+    rl_status_t lib_status = RL_SUCCESS;
+
+    for (size_t ii = 0; ii < sizeof (payload); ii++)
+    {
+        payload[ii] = ii;
+    }
+
+    // Move both indices near end of storage so that records have to wrap.
+    for (size_t lap = 0; lap < 20; lap++)
+    {
+        const size_t record_length = 1 + ( (lap * 37) % sizeof (payload));
+        lib_status |= rl_bipbuffer_queue (&bipbuf, payload, record_length);
+        lib_status |= rl_bipbuffer_queue (&bipbuf, payload + 1, record_length - 1);
+        lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+        TEST_ASSERT (RL_SUCCESS == lib_status);
+        TEST_ASSERT (record_length == length);
+        TEST_ASSERT (!memcmp (payload, p_readback, length));
+        TEST_ASSERT ( (p_readback + length) <= ( (uint8_t *) buffer_data + sizeof (buffer_data)));
+        lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+        TEST_ASSERT (RL_SUCCESS == lib_status);
+        TEST_ASSERT ( (record_length - 1) == length);
+        TEST_ASSERT (!memcmp (payload + 1, p_readback, length));
+        TEST_ASSERT ( (p_readback + length) <= ( (uint8_t *) buffer_data + sizeof (buffer_data)));
+        TEST_ASSERT (rl_bipbuffer_empty (&bipbuf));
+    }
+}
+
+void test_ruuvi_library_bipbuffer_no_mem (void)
+{
+    uint8_t payload[120] = {0};
+    uint8_t * p_readback = NULL;
+    size_t length = 0;
+    rl_status_t lib_status = rl_bipbuffer_queue (&bipbuf, payload, sizeof (payload));
+    lib_status |= rl_bipbuffer_queue (&bipbuf, payload, sizeof (payload));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    // 256 - 2 * 124 leaves 8 bytes at end, start is taken.
+    TEST_ASSERT (RL_ERROR_NO_MEM == rl_bipbuffer_queue (&bipbuf, payload, 8));
+    lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+    // Start is free again, 100-byte record wraps in front of tail.
+    lib_status |= rl_bipbuffer_queue (&bipbuf, payload, 100);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (RL_ERROR_NO_MEM == rl_bipbuffer_queue (&bipbuf, payload, 100));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_bipbuffer_queue (&bipbuf, payload,
+                 sizeof (buffer_data)));
+    // Rounding length up to alignment would wrap around.
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_bipbuffer_reserve (&bipbuf, SIZE_MAX - 1U,
+                 &p_readback));
+}
+
+void test_ruuvi_library_bipbuffer_reserve_commit (void)
+{
+    uint8_t * p_record = NULL;
+    uint8_t * p_readback = NULL;
+    size_t length = 0;
+    rl_status_t lib_status = rl_bipbuffer_reserve (&bipbuf, 5, &p_record);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    memcpy (p_record, "ruuvi", 5);
+    TEST_ASSERT (rl_bipbuffer_empty (&bipbuf));
+    lib_status |= rl_bipbuffer_commit (&bipbuf);
+    TEST_ASSERT (RL_ERROR_INTERNAL == rl_bipbuffer_commit (&bipbuf));
+    lib_status |= rl_bipbuffer_dequeue (&bipbuf, &p_readback, &length);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (5 == length);
+    TEST_ASSERT (!memcmp ("ruuvi", p_readback, length));
+}
+
+void test_ruuvi_library_bipbuffer_null (void)
+{
+    uint8_t * p_readback = NULL;
+    size_t length = 0;
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_queue (NULL, &length, 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_queue (&bipbuf, NULL, 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_reserve (&bipbuf, 1, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_commit (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_peek (NULL, &p_readback, &length));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_peek (&bipbuf, NULL, &length));
+    TEST_ASSERT (RL_ERROR_NULL == rl_bipbuffer_dequeue (&bipbuf, &p_readback, NULL));
+}
+
+static void * producer (void * arg)
+{
+    (void) arg;
+    uint8_t record[64];
+
+    for (uint32_t ii = 0; ii < STRESS_RECORDS; ii++)
+    {
+        const size_t length = 1 + (ii % sizeof (record));
+        memset (record, (uint8_t) ii, length);
+
+        while (RL_SUCCESS != rl_bipbuffer_queue (&bipbuf, record, length))
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+void test_ruuvi_library_bipbuffer_spsc_stress (void)
+{
+    pthread_t thread;
+    uint32_t errors = 0;
+    pthread_create (&thread, NULL, &producer, NULL);
+
+    for (uint32_t ii = 0; ii < STRESS_RECORDS; ii++)
+    {
+        uint8_t * p_record = NULL;
+        size_t length = 0;
+
+        while (RL_SUCCESS != rl_bipbuffer_peek (&bipbuf, &p_record, &length))
+        {
+            sched_yield();
+        }
+
+        errors += (length != (1 + (ii % 64)));
+        errors += (p_record[0] != (uint8_t) ii) || (p_record[length - 1] != (uint8_t) ii);
+        rl_bipbuffer_dequeue (&bipbuf, &p_record, &length);
+    }
+
+    pthread_join (thread, NULL);
+    TEST_ASSERT (0 == errors);
+    TEST_ASSERT (rl_bipbuffer_empty (&bipbuf));
+}
@@ -2,6 +2,8 @@
 
 #include "ruuvi_library.h"
 #include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
 
 #include <string.h>
 
@@ -57,13 +59,27 @@ static rl_ringbuffer_t ringbuf =
     .readlock  = &buffer_rlock
 };
 
+static rl_ringbuffer_t overwrite_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .lock = flag,
+    .writelock = &buffer_wlock,
+    .readlock  = &buffer_rlock,
+    .policy = RL_RINGBUFFER_POLICY_OVERWRITE
+};
+
 void setUp (void)
 {
     buffer_wlock = false;
     buffer_rlock = false;
     memset (buffer_data, 0, sizeof (buffer_data));
-    ringbuf.head = 0;
-    ringbuf.tail = 0;
+    rl_ringbuffer_reset (&ringbuf);
+    rl_ringbuffer_reset (&overwrite_ringbuf);
 }
 
 void tearDown (void)
@@ -346,3 +362,495 @@ void test_ruuvi_library_ringbuffer_peek_no_data (void)
                                       &readback, 50);
     TEST_ASSERT (RL_ERROR_NO_DATA == lib_status);
 }
+
+void test_ruuvi_library_ringbuffer_queue_n_wrap (void)
+{
+    uint8_t data[48] = {0};
+    uint8_t readback[48] = {0};
+    size_t count = sizeof (readback);
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        data[ii] = ii;
+    }
+
+    // Move head and tail close to end of storage so that next batch wraps.
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data, 40);
+    lib_status |= rl_ringbuffer_dequeue_n (&ringbuf, readback, &count);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (40 == count);
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+    lib_status |= rl_ringbuffer_queue_n (&ringbuf, data, sizeof (data));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT ( (ringbuf.head & ringbuf.index_mask) < (ringbuf.tail & ringbuf.index_mask));
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        uint8_t * p_readback = NULL;
+        lib_status |= rl_ringbuffer_peek (&ringbuf, &p_readback, ii);
+        TEST_ASSERT (*p_readback == data[ii]);
+    }
+
+    count = sizeof (readback);
+    memset (readback, 0, sizeof (readback));
+    lib_status |= rl_ringbuffer_dequeue_n (&ringbuf, readback, &count);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (sizeof (data) == count);
+    TEST_ASSERT (!memcmp (data, readback, sizeof (data)));
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_queue_n_no_mem (void)
+{
+    uint8_t data[64] = {0};
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data, 60);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    lib_status = rl_ringbuffer_queue_n (&ringbuf, data, 4);
+    TEST_ASSERT (RL_ERROR_NO_MEM == lib_status);
+    lib_status = rl_ringbuffer_queue_n (&ringbuf, data, 3);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (rl_ringbuffer_full (&ringbuf));
+    lib_status = rl_ringbuffer_queue_n (&ringbuf, data, sizeof (data));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == lib_status);
+}
+
+void test_ruuvi_library_ringbuffer_queue_n_concurrency (void)
+{
+    uint8_t data[4] = {10, 20, 30, 40};
+    buffer_wlock = true;
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data, sizeof (data));
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == lib_status);
+}
+
+void test_ruuvi_library_ringbuffer_queue_n_null (void)
+{
+    uint8_t data[4] = {10, 20, 30, 40};
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_queue_n (NULL, data, sizeof (data)));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_queue_n (&ringbuf, NULL, sizeof (data)));
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_dequeue_n_partial (void)
+{
+    uint8_t data[4] = {10, 20, 30, 40};
+    uint8_t readback[8] = {0};
+    size_t count = sizeof (readback);
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data, sizeof (data));
+    lib_status |= rl_ringbuffer_dequeue_n (&ringbuf, readback, &count);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (sizeof (data) == count);
+    TEST_ASSERT (!memcmp (data, readback, sizeof (data)));
+    lib_status = rl_ringbuffer_dequeue_n (&ringbuf, readback, &count);
+    TEST_ASSERT (RL_ERROR_NO_DATA == lib_status);
+    TEST_ASSERT (0 == count);
+}
+
+void test_ruuvi_library_ringbuffer_dequeue_n_null (void)
+{
+    uint8_t readback[8] = {0};
+    size_t count = sizeof (readback);
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_dequeue_n (NULL, readback, &count));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_dequeue_n (&ringbuf, NULL, &count));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_dequeue_n (&ringbuf, readback, NULL));
+}
+
+void test_ruuvi_library_ringbuffer_reserve_commit (void)
+{
+    uint8_t * p_slot = NULL;
+    uint8_t * p_readback = NULL;
+    rl_status_t lib_status = rl_ringbuffer_reserve (&ringbuf, &p_slot);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (&buffer_data[0] == p_slot);
+    *p_slot = 42;
+    // Element is not visible before commit, and other producers are locked out.
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == rl_ringbuffer_queue (&ringbuf, p_slot, 1));
+    lib_status |= rl_ringbuffer_commit (&ringbuf);
+    TEST_ASSERT (!buffer_wlock);
+    lib_status |= rl_ringbuffer_dequeue (&ringbuf, &p_readback);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (42 == *p_readback);
+    TEST_ASSERT (rl_ringbuffer_empty (&ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_reserve_full (void)
+{
+    uint8_t data[64] = {0};
+    uint8_t * p_slot = NULL;
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data,
+                             ringbuf.index_mask);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    lib_status = rl_ringbuffer_reserve (&ringbuf, &p_slot);
+    TEST_ASSERT (RL_ERROR_NO_MEM == lib_status);
+    TEST_ASSERT (!buffer_wlock);
+    TEST_ASSERT (NULL == p_slot);
+}
+
+void test_ruuvi_library_ringbuffer_reserve_null (void)
+{
+    uint8_t * p_slot = NULL;
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_reserve (NULL, &p_slot));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_reserve (&ringbuf, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_commit (NULL));
+    TEST_ASSERT (!buffer_wlock);
+}
+
+void test_ruuvi_library_ringbuffer_overwrite_keeps_newest (void)
+{
+    uint8_t data[100] = {0};
+    uint8_t * p_readback = NULL;
+    rl_status_t lib_status = RL_SUCCESS;
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        data[ii] = ii;
+        lib_status |= rl_ringbuffer_queue (&overwrite_ringbuf, &data[ii], 1);
+    }
+
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (rl_ringbuffer_full (&overwrite_ringbuf));
+    TEST_ASSERT ( (sizeof (data) - overwrite_ringbuf.index_mask) == overwrite_ringbuf.dropped);
+
+    for (size_t ii = 0; ii < overwrite_ringbuf.index_mask; ii++)
+    {
+        lib_status |= rl_ringbuffer_dequeue (&overwrite_ringbuf, &p_readback);
+        TEST_ASSERT (RL_SUCCESS == lib_status);
+        TEST_ASSERT (*p_readback == data[ii + overwrite_ringbuf.dropped]);
+    }
+
+    TEST_ASSERT (rl_ringbuffer_empty (&overwrite_ringbuf));
+    TEST_ASSERT (!buffer_wlock && !buffer_rlock);
+}
+
+void test_ruuvi_library_ringbuffer_overwrite_queue_n (void)
+{
+    uint8_t data[48] = {0};
+    uint8_t readback[64] = {0};
+    size_t count = sizeof (readback);
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        data[ii] = ii;
+    }
+
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&overwrite_ringbuf, data, 40);
+    lib_status |= rl_ringbuffer_queue_n (&overwrite_ringbuf, data, sizeof (data));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT ( (40 + sizeof (data) - overwrite_ringbuf.index_mask) ==
+                  overwrite_ringbuf.dropped);
+    lib_status |= rl_ringbuffer_dequeue_n (&overwrite_ringbuf, readback, &count);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (overwrite_ringbuf.index_mask == count);
+    // Newest batch is intact at the end.
+    TEST_ASSERT (!memcmp (data, readback + count - sizeof (data), sizeof (data)));
+}
+
+void test_ruuvi_library_ringbuffer_overwrite_concurrency (void)
+{
+    uint8_t data[64] = {0};
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&overwrite_ringbuf, data,
+                             overwrite_ringbuf.index_mask);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    // Consumer is reading, oldest element can't be dropped.
+    buffer_rlock = true;
+    lib_status = rl_ringbuffer_queue (&overwrite_ringbuf, data, 1);
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == lib_status);
+    TEST_ASSERT (!buffer_wlock);
+    TEST_ASSERT (0 == overwrite_ringbuf.dropped);
+}
+
+/**
+ * @brief Fill buffer so that data wraps: tail at 50, 50 elements stored.
+ */
+static void fill_wrapped (rl_ringbuffer_t * const p_buf)
+{
+    uint8_t data[60];
+    uint8_t readback[50];
+    size_t count = sizeof (readback);
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        data[ii] = (uint8_t) ii;
+    }
+
+    rl_status_t lib_status = rl_ringbuffer_queue_n (p_buf, data, 60);
+    lib_status |= rl_ringbuffer_dequeue_n (p_buf, readback, &count);
+    lib_status |= rl_ringbuffer_queue_n (p_buf, data, 40);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+}
+
+void test_ruuvi_library_ringbuffer_peek_range_wrap (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    fill_wrapped (&ringbuf);
+    TEST_ASSERT (50 == rl_ringbuffer_count (&ringbuf));
+    rl_status_t lib_status = rl_ringbuffer_peek_range (&ringbuf, 5, 40, spans);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (&buffer_data[55] == spans[0].data);
+    TEST_ASSERT (9 == spans[0].count);
+    TEST_ASSERT (&buffer_data[0] == spans[1].data);
+    TEST_ASSERT (31 == spans[1].count);
+    // Peeking doesn't consume.
+    TEST_ASSERT (50 == rl_ringbuffer_count (&ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_peek_range_contiguous (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    fill_wrapped (&ringbuf);
+    rl_status_t lib_status = rl_ringbuffer_peek_range (&ringbuf, 20, 30, spans);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (&buffer_data[6] == spans[0].data);
+    TEST_ASSERT (30 == spans[0].count);
+    TEST_ASSERT (NULL == spans[1].data);
+    TEST_ASSERT (0 == spans[1].count);
+}
+
+void test_ruuvi_library_ringbuffer_peek_range_no_data (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    fill_wrapped (&ringbuf);
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_peek_range (&ringbuf, 20, 31, spans));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_peek_range (&ringbuf, 51, 0, spans));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_peek_range (&ringbuf, SIZE_MAX, 2, spans));
+}
+
+void test_ruuvi_library_ringbuffer_peek_range_null (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_peek_range (NULL, 0, 0, spans));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_peek_range (&ringbuf, 0, 0, NULL));
+}
+
+void test_ruuvi_library_ringbuffer_peek_range_rms (void)
+{
+    static float samples[16];
+    static rl_ringbuffer_t sample_ringbuf =
+    {
+        .head = 0,
+        .tail = 0,
+        .block_size = sizeof (samples[0]),
+        .storage_size = sizeof (samples),
+        .index_mask = (sizeof (samples) / sizeof (samples[0])) - 1,
+        .storage = samples,
+        .lock = NULL,
+        .writelock = NULL,
+        .readlock  = NULL,
+        .policy = RL_RINGBUFFER_POLICY_OVERWRITE
+    };
+    float flat[8];
+    rl_ringbuffer_span_t spans[2];
+    rl_status_t lib_status = RL_SUCCESS;
+    rl_ringbuffer_reset (&sample_ringbuf);
+
+    // Overwrite wraps the window of last 8 samples around end of storage.
+    for (size_t ii = 0; ii < 20; ii++)
+    {
+        const float sample = (float) ii - 10.0F;
+        lib_status |= rl_ringbuffer_queue (&sample_ringbuf, &sample, sizeof (sample));
+
+        if (ii >= 12)
+        {
+            flat[ii - 12] = sample;
+        }
+    }
+
+    const size_t stored = rl_ringbuffer_count (&sample_ringbuf);
+    lib_status |= rl_ringbuffer_peek_range (&sample_ringbuf, stored - 8, 8, spans);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (0 < spans[1].count);
+    // Combine per-span mean squares into RMS of the whole window.
+    const float rms0 = rl_rms (spans[0].data, spans[0].count);
+    const float rms1 = rl_rms (spans[1].data, spans[1].count);
+    const float rms = sqrtf ( ( (rms0 * rms0 * spans[0].count)
+                                + (rms1 * rms1 * spans[1].count)) / 8.0F);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, rl_rms (flat, 8), rms);
+}
+
+void test_ruuvi_library_ringbuffer_stats_counts (void)
+{
+#if RL_RINGBUFFER_STATS_ENABLED
+    uint8_t data[8] = {0};
+    uint8_t readback[8] = {0};
+    size_t count = 2;
+    rl_ringbuffer_stats_t stats;
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&ringbuf, data, 5);
+    lib_status |= rl_ringbuffer_dequeue_n (&ringbuf, readback, &count);
+    lib_status |= rl_ringbuffer_stats_get (&ringbuf, &stats);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (5 == stats.queued);
+    TEST_ASSERT (2 == stats.dequeued);
+    TEST_ASSERT (5 == stats.peak);
+    TEST_ASSERT (0 == stats.rejected);
+
+    while (RL_SUCCESS == rl_ringbuffer_queue (&ringbuf, data, 1)) {}
+
+    TEST_ASSERT (RL_ERROR_NO_MEM == rl_ringbuffer_queue_n (&ringbuf, data, 4));
+    rl_ringbuffer_stats_get (&ringbuf, &stats);
+    TEST_ASSERT (5 + ringbuf.index_mask - 3 == stats.queued);
+    TEST_ASSERT (ringbuf.index_mask == stats.peak);
+    TEST_ASSERT (1 + 4 == stats.rejected);
+    TEST_ASSERT (0 == stats.lock_failures);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_STATS_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_stats_lock_failures (void)
+{
+#if RL_RINGBUFFER_STATS_ENABLED
+    uint8_t data = 0;
+    uint8_t * p_readback = NULL;
+    rl_ringbuffer_stats_t stats;
+    buffer_wlock = true;
+    buffer_rlock = true;
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == rl_ringbuffer_queue (&ringbuf, &data, 1));
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == rl_ringbuffer_dequeue (&ringbuf, &p_readback));
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == rl_ringbuffer_peek (&ringbuf, &p_readback, 0));
+    rl_ringbuffer_stats_get (&ringbuf, &stats);
+    TEST_ASSERT (3 == stats.lock_failures);
+    TEST_ASSERT (0 == stats.queued);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_STATS_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_stats_overwrite_reset (void)
+{
+#if RL_RINGBUFFER_STATS_ENABLED
+    uint8_t data = 0;
+    rl_ringbuffer_stats_t stats;
+
+    for (size_t ii = 0; ii < 70; ii++)
+    {
+        rl_ringbuffer_queue (&overwrite_ringbuf, &data, 1);
+    }
+
+    rl_ringbuffer_stats_get (&overwrite_ringbuf, &stats);
+    TEST_ASSERT (70 == stats.queued);
+    TEST_ASSERT (70 - overwrite_ringbuf.index_mask == stats.dropped);
+    TEST_ASSERT (0 == stats.rejected);
+    rl_ringbuffer_stats_reset (&overwrite_ringbuf);
+    rl_ringbuffer_stats_get (&overwrite_ringbuf, &stats);
+    TEST_ASSERT (0 == stats.queued);
+    TEST_ASSERT (0 == stats.dropped);
+    TEST_ASSERT (0 == stats.peak);
+    // Peak is measured again from current occupancy.
+    rl_ringbuffer_queue (&overwrite_ringbuf, &data, 1);
+    rl_ringbuffer_stats_get (&overwrite_ringbuf, &stats);
+    TEST_ASSERT (overwrite_ringbuf.index_mask == stats.peak);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_STATS_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_stats_null (void)
+{
+#if RL_RINGBUFFER_STATS_ENABLED
+    rl_ringbuffer_stats_t stats;
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_stats_get (NULL, &stats));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_stats_get (&ringbuf, NULL));
+    rl_ringbuffer_stats_reset (NULL);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_STATS_ENABLED is 0");
+#endif
+}
+
+/**
+ * @brief Element with leading timestamp, laid out like rl_data_t.
+ */
+typedef struct
+{
+    uint32_t time;
+    float payload[3];
+} timed_sample_t;
+
+static timed_sample_t timed_data[256];
+static rl_ringbuffer_t timed_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (timed_data[0]),
+    .storage_size = sizeof (timed_data),
+    .index_mask = (sizeof (timed_data) / sizeof (timed_data[0])) - 1,
+    .storage = timed_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL,
+    .policy = RL_RINGBUFFER_POLICY_OVERWRITE
+};
+
+/**
+ * @brief Queue count samples every 10 ticks from start, with some duplicate timestamps.
+ */
+static void queue_timed (const uint32_t start, const size_t count)
+{
+    rl_ringbuffer_reset (&timed_ringbuf);
+
+    for (size_t ii = 0; ii < count; ii++)
+    {
+        const timed_sample_t sample = {.time = start + (uint32_t) ( (ii / 2) * 10)};
+        rl_ringbuffer_queue (&timed_ringbuf, &sample, sizeof (sample));
+    }
+}
+
+/**
+ * @brief Reference linear search.
+ */
+static size_t find_linear (const uint32_t time)
+{
+    timed_sample_t * p_sample = NULL;
+    size_t index = 0;
+
+    while ( (RL_SUCCESS == rl_ringbuffer_peek (&timed_ringbuf, &p_sample, index))
+            && ( (int32_t) (p_sample->time - time) < 0))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+void test_ruuvi_library_ringbuffer_find_time_matches_linear (void)
+{
+    // 400 samples overwrite the oldest ones, storage wraps.
+    queue_timed (1000, 400);
+    const size_t stored = rl_ringbuffer_count (&timed_ringbuf);
+
+    for (uint32_t time = 900; time < 3100; time += 3)
+    {
+        size_t index = SIZE_MAX;
+        const rl_status_t lib_status = rl_ringbuffer_find_time (&timed_ringbuf, time, &index);
+        TEST_ASSERT_EQUAL (find_linear (time), index);
+        TEST_ASSERT ( (index < stored) ? (RL_SUCCESS == lib_status)
+                      : (RL_ERROR_NO_DATA == lib_status));
+    }
+}
+
+void test_ruuvi_library_ringbuffer_find_time_counter_wrap (void)
+{
+    size_t index = 0;
+    timed_sample_t * p_sample = NULL;
+    queue_timed (UINT32_MAX - 500, 200);
+    // Timestamp counter wrapped to small values in the middle of the buffer.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_find_time (&timed_ringbuf, 5, &index));
+    TEST_ASSERT_EQUAL (find_linear (5), index);
+    rl_ringbuffer_peek (&timed_ringbuf, &p_sample, index);
+    TEST_ASSERT (9 == p_sample->time);
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_find_time (&timed_ringbuf, UINT32_MAX - 600,
+                 &index));
+    TEST_ASSERT (0 == index);
+}
+
+void test_ruuvi_library_ringbuffer_find_time_empty (void)
+{
+    size_t index = SIZE_MAX;
+    rl_ringbuffer_reset (&timed_ringbuf);
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_find_time (&timed_ringbuf, 0, &index));
+    TEST_ASSERT (0 == index);
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_find_time (NULL, 0, &index));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_find_time (&timed_ringbuf, 0, NULL));
+    // One-byte elements can't hold a timestamp.
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_find_time (&ringbuf, 0, &index));
+}
@@ -0,0 +1,216 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer_broadcast.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define READERS (3U) //!< Number of reader cursors.
+#define STRESS_ELEMENTS (200000U) //!< Number of elements broadcast in stress test.
+
+static uint32_t buffer_data[16] = {0};
+static _Atomic size_t buffer_cursors[READERS];
+static rl_ringbuffer_broadcast_t ringbuf =
+{
+    .head = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .cursors = buffer_cursors,
+    .reader_count = READERS
+};
+
+void setUp (void)
+{
+    memset (buffer_data, 0, sizeof (buffer_data));
+    rl_ringbuffer_broadcast_init (&ringbuf);
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * @brief Queue values from start to start + count - 1.
+ */
+static rl_status_t queue_sequence (const uint32_t start, const uint32_t count)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    for (uint32_t ii = start; ii < (start + count); ii++)
+    {
+        err_code |= rl_ringbuffer_broadcast_queue (&ringbuf, &ii, sizeof (ii));
+    }
+
+    return err_code;
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_every_reader_sees_data (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (0, 4));
+
+    for (size_t reader = 0; reader < READERS; reader++)
+    {
+        TEST_ASSERT (4 == rl_ringbuffer_broadcast_count (&ringbuf, reader));
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_peek (&ringbuf, reader, spans));
+        // Readers share the stored copy.
+        TEST_ASSERT (&buffer_data[0] == spans[0].data);
+        TEST_ASSERT (4 == spans[0].count);
+        TEST_ASSERT (0 == spans[1].count);
+    }
+
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 0, 4));
+    TEST_ASSERT (0 == rl_ringbuffer_broadcast_count (&ringbuf, 0));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_broadcast_peek (&ringbuf, 0, spans));
+    TEST_ASSERT (4 == rl_ringbuffer_broadcast_count (&ringbuf, 1));
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_slowest_reader_holds_space (void)
+{
+    const uint32_t slots = ringbuf.index_mask + 1;
+    uint32_t data = 0;
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (0, slots));
+    TEST_ASSERT (RL_ERROR_NO_MEM == rl_ringbuffer_broadcast_queue (&ringbuf, &data,
+                 sizeof (data)));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 0, slots));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 1, slots));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 2, 1));
+    // Reader 2 is slowest and has released only one slot.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_queue (&ringbuf, &data,
+                 sizeof (data)));
+    TEST_ASSERT (RL_ERROR_NO_MEM == rl_ringbuffer_broadcast_queue (&ringbuf, &data,
+                 sizeof (data)));
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_wrap (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (0, 12));
+
+    for (size_t reader = 0; reader < READERS; reader++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, reader, 10));
+    }
+
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (12, 10));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_peek (&ringbuf, 1, spans));
+    TEST_ASSERT (6 == spans[0].count);
+    TEST_ASSERT (6 == spans[1].count);
+    TEST_ASSERT (10 == ( (const uint32_t *) spans[0].data) [0]);
+    TEST_ASSERT (16 == ( (const uint32_t *) spans[1].data) [0]);
+    TEST_ASSERT (21 == ( (const uint32_t *) spans[1].data) [5]);
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_detach_attach (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    const uint32_t slots = ringbuf.index_mask + 1;
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (0, slots));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 0, slots));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_release (&ringbuf, 1, slots));
+    // Detached reader doesn't block producer.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_detach (&ringbuf, 2));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_broadcast_peek (&ringbuf, 2, spans));
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_broadcast_release (&ringbuf, 2, 1));
+    TEST_ASSERT (0 == rl_ringbuffer_broadcast_count (&ringbuf, 2));
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (slots, 4));
+    // Attached reader sees only new data.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_attach (&ringbuf, 2));
+    TEST_ASSERT (0 == rl_ringbuffer_broadcast_count (&ringbuf, 2));
+    TEST_ASSERT (RL_SUCCESS == queue_sequence (slots + 4, 1));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_broadcast_peek (&ringbuf, 2, spans));
+    TEST_ASSERT (1 == spans[0].count);
+    TEST_ASSERT ( (slots + 4) == * (const uint32_t *) spans[0].data);
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_invalid (void)
+{
+    rl_ringbuffer_span_t spans[2];
+    uint32_t data = 0;
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_broadcast_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_broadcast_queue (NULL, &data, 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_broadcast_queue (&ringbuf, NULL, 1));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_broadcast_queue (&ringbuf, &data,
+                 sizeof (data) + 1));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_broadcast_peek (&ringbuf, 0, NULL));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_broadcast_peek (&ringbuf, READERS,
+                 spans));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_broadcast_release (&ringbuf, 0, 1));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_broadcast_attach (&ringbuf, READERS));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_broadcast_detach (&ringbuf, READERS));
+    TEST_ASSERT (0 == rl_ringbuffer_broadcast_count (&ringbuf, READERS));
+}
+
+static void * reader_thread (void * arg)
+{
+    const size_t reader = (size_t) arg;
+    rl_ringbuffer_span_t spans[2];
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+
+    while (expected < STRESS_ELEMENTS)
+    {
+        if (RL_SUCCESS != rl_ringbuffer_broadcast_peek (&ringbuf, reader, spans))
+        {
+            sched_yield();
+            continue;
+        }
+
+        const size_t count = spans[0].count + spans[1].count;
+
+        for (size_t span = 0; span < 2; span++)
+        {
+            const uint32_t * const p_data = spans[span].data;
+
+            for (size_t ii = 0; ii < spans[span].count; ii++)
+            {
+                errors += (p_data[ii] != expected++);
+            }
+        }
+
+        errors += (RL_SUCCESS != rl_ringbuffer_broadcast_release (&ringbuf, reader, count));
+    }
+
+    return (void *) (uintptr_t) errors;
+}
+
+void test_ruuvi_library_ringbuffer_broadcast_stress (void)
+{
+    pthread_t threads[READERS];
+    uintptr_t errors = 0;
+
+    for (size_t reader = 0; reader < READERS; reader++)
+    {
+        pthread_create (&threads[reader], NULL, &reader_thread, (void *) reader);
+    }
+
+    for (uint32_t ii = 0; ii < STRESS_ELEMENTS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_broadcast_queue (&ringbuf, &ii, sizeof (ii)))
+        {
+            // Slowest reader has not released the slot yet.
+            sched_yield();
+        }
+    }
+
+    for (size_t reader = 0; reader < READERS; reader++)
+    {
+        void * result = NULL;
+        pthread_join (threads[reader], &result);
+        errors += (uintptr_t) result;
+    }
+
+    TEST_ASSERT (0 == errors);
+
+    for (size_t reader = 0; reader < READERS; reader++)
+    {
+        TEST_ASSERT (0 == rl_ringbuffer_broadcast_count (&ringbuf, reader));
+    }
+}
@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_ringbuffer_file.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define ELEMENTS (64U) //!< Number of slots in file-backed buffer.
+
+#if RL_RINGBUFFER_FILE_ENABLED
+static const rl_ringbuffer_t config =
+{
+    .block_size = sizeof (uint32_t),
+    .storage_size = ELEMENTS * sizeof (uint32_t),
+    .index_mask = ELEMENTS - 1,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL
+};
+#endif
+
+static char path[] = "/tmp/test_ruuvi_library_ringbuffer_file_XXXXXX";
+
+void setUp (void)
+{
+    strcpy (path + strlen (path) - 6, "XXXXXX");
+    close (mkstemp (path));
+}
+
+void tearDown (void)
+{
+    unlink (path);
+}
+
+void test_ruuvi_library_ringbuffer_file_survives_reopen (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file;
+    uint32_t * p_data = NULL;
+    rl_status_t lib_status = rl_ringbuffer_file_open (&file, path, &config);
+    TEST_ASSERT (rl_ringbuffer_empty (file.buffer));
+
+    for (uint32_t ii = 0; ii < 10; ii++)
+    {
+        lib_status |= rl_ringbuffer_queue (file.buffer, &ii, sizeof (ii));
+    }
+
+    lib_status |= rl_ringbuffer_dequeue (file.buffer, &p_data);
+    lib_status |= rl_ringbuffer_file_close (&file);
+    TEST_ASSERT (NULL == file.buffer);
+    lib_status |= rl_ringbuffer_file_open (&file, path, &config);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (9 == rl_ringbuffer_count (file.buffer));
+
+    for (uint32_t ii = 1; ii < 10; ii++)
+    {
+        lib_status |= rl_ringbuffer_dequeue (file.buffer, &p_data);
+        TEST_ASSERT (ii == *p_data);
+    }
+
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_file_close (&file));
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_file_survives_crash (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file;
+    uint32_t * p_data = NULL;
+    int status = 0;
+    const pid_t pid = fork();
+
+    if (0 == pid)
+    {
+        // Child queues elements and dies without closing or syncing.
+        rl_status_t child_status = rl_ringbuffer_file_open (&file, path, &config);
+
+        for (uint32_t ii = 0; ii < 20; ii++)
+        {
+            child_status |= rl_ringbuffer_queue (file.buffer, &ii, sizeof (ii));
+        }
+
+        // Reserved but never committed slot must not show up.
+        child_status |= rl_ringbuffer_reserve (file.buffer, &p_data);
+        *p_data = 0xDEADBEEFU;
+        _exit ( (RL_SUCCESS == child_status) ? 0 : 1);
+    }
+
+    waitpid (pid, &status, 0);
+    TEST_ASSERT (WIFEXITED (status) && (0 == WEXITSTATUS (status)));
+    rl_status_t lib_status = rl_ringbuffer_file_open (&file, path, &config);
+    TEST_ASSERT (20 == rl_ringbuffer_count (file.buffer));
+
+    for (uint32_t ii = 0; ii < 20; ii++)
+    {
+        lib_status |= rl_ringbuffer_dequeue (file.buffer, &p_data);
+        TEST_ASSERT (ii == *p_data);
+    }
+
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_dequeue (file.buffer, &p_data));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    rl_ringbuffer_file_close (&file);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_file_geometry_mismatch (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file;
+    const rl_ringbuffer_t other =
+    {
+        .block_size = sizeof (uint64_t),
+        .storage_size = (ELEMENTS / 2) * sizeof (uint64_t),
+        .index_mask = (ELEMENTS / 2) - 1
+    };
+    uint32_t data = 1;
+    rl_status_t lib_status = rl_ringbuffer_file_open (&file, path, &config);
+    lib_status |= rl_ringbuffer_queue (file.buffer, &data, sizeof (data));
+    lib_status |= rl_ringbuffer_file_close (&file);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    // Same file size, different block size.
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_file_open (&file, path, &other));
+    TEST_ASSERT (NULL == file.buffer);
+    // Data is kept for a matching reader.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_file_open (&file, path, &config));
+    TEST_ASSERT (1 == rl_ringbuffer_count (file.buffer));
+    rl_ringbuffer_file_close (&file);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
+
+/**
+ * @brief Overwrite first 4 bytes of file, where magic is.
+ */
+static void magic_write (const uint32_t magic)
+{
+    const int fd = open (path, O_WRONLY);
+    TEST_ASSERT (sizeof (magic) == pwrite (fd, &magic, sizeof (magic), 0));
+    close (fd);
+}
+
+void test_ruuvi_library_ringbuffer_file_foreign (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file;
+    uint32_t data = 1;
+    uint32_t magic = 0;
+    rl_status_t lib_status = rl_ringbuffer_file_open (&file, path, &config);
+    lib_status |= rl_ringbuffer_queue (file.buffer, &data, sizeof (data));
+    lib_status |= rl_ringbuffer_file_close (&file);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    // File of the right size which isn't a ringbuffer is not overwritten.
+    magic_write (0x464C457FU);
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_file_open (&file, path, &config));
+    const int fd = open (path, O_RDONLY);
+    TEST_ASSERT (sizeof (magic) == pread (fd, &magic, sizeof (magic), 0));
+    close (fd);
+    TEST_ASSERT (0x464C457FU == magic);
+    // Creation interrupted before magic was written starts over.
+    magic_write (0);
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_file_open (&file, path, &config));
+    TEST_ASSERT (rl_ringbuffer_empty (file.buffer));
+    rl_ringbuffer_file_close (&file);
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_file_corrupt_index (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file;
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_file_open (&file, path, &config));
+    atomic_store (&file.buffer->head, ELEMENTS + 3);
+    munmap (file.mapping, file.mapping_size);
+    close (file.fd);
+    TEST_ASSERT (RL_ERROR_INTERNAL == rl_ringbuffer_file_open (&file, path, &config));
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
+
+void test_ruuvi_library_ringbuffer_file_null (void)
+{
+#if RL_RINGBUFFER_FILE_ENABLED
+    rl_ringbuffer_file_t file = {0};
+    const rl_ringbuffer_t bad =
+    {
+        .block_size = sizeof (uint32_t),
+        .storage_size = ELEMENTS * sizeof (uint32_t),
+        .index_mask = ELEMENTS
+    };
+    const rl_ringbuffer_t not_power_of_two =
+    {
+        .block_size = sizeof (uint32_t),
+        .storage_size = 6U * sizeof (uint32_t),
+        .index_mask = 5U
+    };
+    // Storage size wraps around to 0.
+    const rl_ringbuffer_t overflow =
+    {
+        .block_size = sizeof (uint32_t),
+        .storage_size = 0,
+        .index_mask = SIZE_MAX / 2U
+    };
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_file_open (NULL, path, &config));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_file_open (&file, NULL, &config));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_file_open (&file, path, NULL));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_file_open (&file, path, &bad));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_file_open (&file, path,
+                 &not_power_of_two));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_file_open (&file, path, &overflow));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_file_sync (&file));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_file_close (NULL));
+#else
+    TEST_IGNORE_MESSAGE ("RL_RINGBUFFER_FILE_ENABLED is 0");
+#endif
+}
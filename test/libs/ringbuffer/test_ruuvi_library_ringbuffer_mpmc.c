@@ -0,0 +1,298 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_ringbuffer_mpmc.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ELEMENTS  (200000U) //!< Elements pushed through buffer per benchmark round.
+#define BENCH_CONSUMERS (4U)      //!< Consumer threads in benchmark.
+#define MAX_PRODUCERS   (16U)     //!< Largest number of producers in benchmark.
+
+/**
+ * @brief Thread-safe try-lock for the locked reference path.
+ */
+static bool flag (volatile uint32_t * const flag, const bool lock)
+{
+    _Atomic uint32_t * p_flag = (_Atomic uint32_t *) flag;
+
+    if (lock)
+    {
+        uint32_t expected = 0;
+        return atomic_compare_exchange_strong (p_flag, &expected, 1U);
+    }
+
+    atomic_store (p_flag, 0U);
+    return true;
+}
+
+static uint32_t buffer_data[256] = {0};
+static _Atomic size_t buffer_seq[256];
+static _Atomic uint32_t buffer_wlock = 0;
+static _Atomic uint32_t buffer_rlock = 0;
+static volatile uint32_t consumer_lock = 0; //!< Serializes locked baseline consumers.
+static rl_ringbuffer_mpmc_t mpmc_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .sequence = buffer_seq
+};
+static rl_ringbuffer_t locked_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .lock = flag,
+    .writelock = &buffer_wlock,
+    .readlock  = &buffer_rlock
+};
+
+typedef struct
+{
+    bool mpmc;                 //!< True to use MPMC buffer, false for locked buffer.
+    uint32_t first;            //!< First value to produce.
+    uint32_t count;            //!< Number of values to produce or consume.
+    uint64_t sum;              //!< Sum of consumed values.
+    uint32_t retries;          //!< Number of failed operations.
+} worker_t;
+
+static _Atomic uint32_t m_consumed = 0;
+
+void setUp (void)
+{
+    buffer_wlock = 0;
+    buffer_rlock = 0;
+    consumer_lock = 0;
+    memset (buffer_data, 0, sizeof (buffer_data));
+    rl_ringbuffer_mpmc_init (&mpmc_ringbuf);
+    rl_ringbuffer_reset (&locked_ringbuf);
+    m_consumed = 0;
+}
+
+void tearDown (void)
+{
+}
+
+static rl_status_t put (const worker_t * const p_worker, const uint32_t value)
+{
+    return p_worker->mpmc ? rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, &value,
+            sizeof (value))
+           : rl_ringbuffer_queue (&locked_ringbuf, &value, sizeof (value));
+}
+
+static rl_status_t get (const worker_t * const p_worker, uint32_t * const p_value)
+{
+    rl_status_t err_code = RL_SUCCESS;
+
+    if (p_worker->mpmc)
+    {
+        err_code = rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, p_value, sizeof (*p_value));
+    }
+    else
+    {
+        // Slot may be refilled as soon as tail moves, copy it before dequeue.
+        // Consumers take turns so that each element is copied once.
+        if (!flag (&consumer_lock, true)) { return RL_ERROR_CONCURRENCY; }
+
+        uint32_t * p_data = NULL;
+        err_code = rl_ringbuffer_peek (&locked_ringbuf, &p_data, 0);
+
+        if (RL_SUCCESS == err_code)
+        {
+            *p_value = *p_data;
+            err_code = rl_ringbuffer_dequeue (&locked_ringbuf, &p_data);
+        }
+
+        flag (&consumer_lock, false);
+    }
+
+    return err_code;
+}
+
+static void * producer (void * arg)
+{
+    worker_t * const p_worker = (worker_t *) arg;
+
+    for (uint32_t ii = 0; ii < p_worker->count; ii++)
+    {
+        while (RL_SUCCESS != put (p_worker, p_worker->first + ii))
+        {
+            p_worker->retries++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void * consumer (void * arg)
+{
+    worker_t * const p_worker = (worker_t *) arg;
+    uint32_t value = 0;
+
+    while (atomic_load (&m_consumed) < BENCH_ELEMENTS)
+    {
+        if (RL_SUCCESS == get (p_worker, &value))
+        {
+            p_worker->sum += value;
+            p_worker->count++;
+            atomic_fetch_add (&m_consumed, 1U);
+        }
+        else
+        {
+            p_worker->retries++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Run producers and consumers over buffer until BENCH_ELEMENTS have been moved.
+ *
+ * @return true if every produced value was consumed exactly once.
+ */
+static bool bench_run (const bool mpmc, const uint32_t producers)
+{
+    pthread_t threads[MAX_PRODUCERS + BENCH_CONSUMERS];
+    worker_t workers[MAX_PRODUCERS + BENCH_CONSUMERS] = {0};
+    const uint32_t per_producer = BENCH_ELEMENTS / producers;
+    const uint32_t total = per_producer * producers;
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    uint32_t retries = 0;
+    struct timespec start;
+    struct timespec end;
+    setUp();
+    // Consumers stop once they have the total, remainder of division is never produced.
+    atomic_store (&m_consumed, BENCH_ELEMENTS - total);
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    for (uint32_t ii = 0; ii < producers; ii++)
+    {
+        workers[ii].mpmc = mpmc;
+        workers[ii].first = ii * per_producer;
+        workers[ii].count = per_producer;
+        pthread_create (&threads[ii], NULL, &producer, &workers[ii]);
+    }
+
+    for (uint32_t ii = producers; ii < producers + BENCH_CONSUMERS; ii++)
+    {
+        workers[ii].mpmc = mpmc;
+        pthread_create (&threads[ii], NULL, &consumer, &workers[ii]);
+    }
+
+    for (uint32_t ii = 0; ii < producers + BENCH_CONSUMERS; ii++)
+    {
+        pthread_join (threads[ii], NULL);
+        retries += workers[ii].retries;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &end);
+
+    for (uint32_t ii = producers; ii < producers + BENCH_CONSUMERS; ii++)
+    {
+        sum += workers[ii].sum;
+        count += workers[ii].count;
+    }
+
+    const double elapsed = (end.tv_sec - start.tv_sec)
+                           + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+    printf ("%s, %2u producers: %.1f M elements / s, %u retries\n",
+            mpmc ? "mpmc  " : "locked", producers, (total / elapsed) / 1e6, retries);
+    return (count == total) && (sum == ( (uint64_t) total * (total - 1U)) / 2U);
+}
+
+void test_ruuvi_library_ringbuffer_mpmc_queue_dequeue (void)
+{
+    uint32_t data = 0xAABBCCDDU;
+    uint32_t readback = 0;
+    TEST_ASSERT (rl_ringbuffer_mpmc_empty (&mpmc_ringbuf));
+    rl_status_t lib_status = rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, &data,
+                             sizeof (data));
+    TEST_ASSERT (!rl_ringbuffer_mpmc_empty (&mpmc_ringbuf));
+    lib_status |= rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, &readback,
+                  sizeof (readback));
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (readback == data);
+    TEST_ASSERT (rl_ringbuffer_mpmc_empty (&mpmc_ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_mpmc_overfill (void)
+{
+    rl_status_t lib_status = RL_SUCCESS;
+    uint32_t queued = 0;
+
+    while (RL_SUCCESS == lib_status)
+    {
+        lib_status = rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, &queued, sizeof (queued));
+        queued += (RL_SUCCESS == lib_status);
+    }
+
+    TEST_ASSERT (RL_ERROR_NO_MEM == lib_status);
+    TEST_ASSERT ( (mpmc_ringbuf.index_mask + 1) == queued);
+    TEST_ASSERT (rl_ringbuffer_mpmc_full (&mpmc_ringbuf));
+
+    // Elements come out in order and every slot can be reused.
+    for (uint32_t ii = 0; ii < 2 * queued; ii++)
+    {
+        uint32_t readback = 0;
+        lib_status = rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, &readback,
+                     sizeof (readback));
+        TEST_ASSERT (RL_SUCCESS == lib_status);
+        TEST_ASSERT (ii == readback);
+        const uint32_t next = ii + queued;
+        lib_status = rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, &next, sizeof (next));
+        TEST_ASSERT (RL_SUCCESS == lib_status);
+    }
+}
+
+void test_ruuvi_library_ringbuffer_mpmc_underflow (void)
+{
+    uint32_t readback = 0;
+    rl_status_t lib_status = rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, &readback,
+                             sizeof (readback));
+    TEST_ASSERT (RL_ERROR_NO_DATA == lib_status);
+}
+
+void test_ruuvi_library_ringbuffer_mpmc_input_check (void)
+{
+    uint32_t data[2] = {0};
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_mpmc_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_mpmc_queue (NULL, data, sizeof (data[0])));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, NULL,
+                 sizeof (data[0])));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_mpmc_queue (&mpmc_ringbuf, data,
+                 sizeof (data)));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_mpmc_dequeue (NULL, data,
+                 sizeof (data[0])));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, NULL,
+                 sizeof (data[0])));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_mpmc_dequeue (&mpmc_ringbuf, data,
+                 sizeof (data)));
+    TEST_ASSERT (rl_ringbuffer_mpmc_empty (&mpmc_ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_mpmc_contention (void)
+{
+    for (uint32_t producers = 1; producers <= MAX_PRODUCERS; producers *= 2)
+    {
+        TEST_ASSERT (bench_run (false, producers));
+        TEST_ASSERT (bench_run (true, producers));
+    }
+}
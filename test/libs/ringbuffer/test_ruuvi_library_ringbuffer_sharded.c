@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_ringbuffer_sharded.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SHARDS         (8U)      //!< Number of shards, largest core count in benchmark.
+#define SHARD_ELEMENTS (256U)    //!< Slots per shard.
+#define BENCH_ELEMENTS (400000U) //!< Elements pushed through queue per benchmark round.
+#define BATCH          (32U)     //!< Elements per consumer dequeue.
+#define PRODUCER_SHIFT (24U)     //!< Bit position of producer index in benchmark values.
+
+/**
+ * @brief Thread-safe try-lock for shards.
+ */
+static bool flag (volatile uint32_t * const flag, const bool lock)
+{
+    _Atomic uint32_t * p_flag = (_Atomic uint32_t *) flag;
+
+    if (lock)
+    {
+        uint32_t expected = 0;
+        return atomic_compare_exchange_strong (p_flag, &expected, 1U);
+    }
+
+    atomic_store (p_flag, 0U);
+    return true;
+}
+
+static uint32_t shard_data[SHARDS][SHARD_ELEMENTS];
+static _Atomic uint32_t shard_wlock[SHARDS];
+static _Atomic uint32_t shard_rlock[SHARDS];
+#define SHARD(n) { .block_size = sizeof (uint32_t), \
+                   .storage_size = sizeof (shard_data[n]), \
+                   .index_mask = SHARD_ELEMENTS - 1, \
+                   .storage = shard_data[n], \
+                   .lock = flag, \
+                   .writelock = &shard_wlock[n], \
+                   .readlock = &shard_rlock[n] }
+static rl_ringbuffer_t shards[SHARDS] =
+{
+    SHARD (0), SHARD (1), SHARD (2), SHARD (3), SHARD (4), SHARD (5), SHARD (6), SHARD (7)
+};
+static rl_ringbuffer_sharded_t queue = {.shards = shards, .shard_count = SHARDS};
+
+typedef struct
+{
+    rl_ringbuffer_sharded_t * queue; //!< Queue under test.
+    uint32_t index;                  //!< Index of thread, also its local shard.
+    uint32_t count;                  //!< Number of values to produce, or consumed.
+    uint32_t errors;                 //!< Values consumed out of producer order.
+    uint64_t sum;                    //!< Sum of consumed values.
+} worker_t;
+
+static _Atomic uint32_t m_consumed = 0;
+
+void setUp (void)
+{
+    memset (shard_data, 0, sizeof (shard_data));
+    rl_ringbuffer_sharded_init (&queue);
+    m_consumed = 0;
+}
+
+void tearDown (void)
+{
+}
+
+void test_ruuvi_library_ringbuffer_sharded_local_first (void)
+{
+    uint32_t data[4] = {0};
+    size_t count = 4;
+
+    for (uint32_t ii = 0; ii < 4; ii++)
+    {
+        const uint32_t local = ii;
+        const uint32_t remote = 100 + ii;
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_queue (&queue, 2, &local,
+                     sizeof (local)));
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_queue (&queue, 5, &remote,
+                     sizeof (remote)));
+    }
+
+    TEST_ASSERT (8 == rl_ringbuffer_sharded_count (&queue));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_dequeue_n (&queue, 2, data, &count));
+    TEST_ASSERT (4 == count);
+
+    for (uint32_t ii = 0; ii < 4; ii++)
+    {
+        TEST_ASSERT (ii == data[ii]);
+    }
+}
+
+void test_ruuvi_library_ringbuffer_sharded_steal_half (void)
+{
+    const uint32_t elements[5] = {10, 11, 12, 13, 14};
+    uint32_t data[8] = {0};
+    size_t count = 8;
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_queue_n (&queue, 6, elements, 5));
+    // Local shard 1 is empty, victim keeps the newer half.
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_dequeue_n (&queue, 1, data, &count));
+    TEST_ASSERT (3 == count);
+    TEST_ASSERT (10 == data[0]);
+    TEST_ASSERT (12 == data[2]);
+    TEST_ASSERT (2 == rl_ringbuffer_count (&shards[6]));
+    count = 8;
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_dequeue_n (&queue, 6, data, &count));
+    TEST_ASSERT (2 == count);
+    TEST_ASSERT (13 == data[0]);
+    count = 8;
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_sharded_dequeue_n (&queue, 6, data,
+                 &count));
+    TEST_ASSERT (0 == count);
+}
+
+void test_ruuvi_library_ringbuffer_sharded_skip_busy (void)
+{
+    uint32_t data[2] = {0};
+    const uint32_t value = 7;
+    size_t count = 2;
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_queue (&queue, 3, &value,
+                 sizeof (value)));
+    // Another consumer holds the read lock of the only non-empty shard.
+    shard_rlock[3] = 1;
+    TEST_ASSERT (RL_ERROR_CONCURRENCY == rl_ringbuffer_sharded_dequeue_n (&queue, 0, data,
+                 &count));
+    shard_rlock[3] = 0;
+    count = 2;
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_sharded_dequeue_n (&queue, 0, data, &count));
+    TEST_ASSERT (1 == count);
+    TEST_ASSERT (value == data[0]);
+}
+
+void test_ruuvi_library_ringbuffer_sharded_invalid (void)
+{
+    rl_ringbuffer_t unlocked[1] =
+    {
+        {
+            .block_size = sizeof (uint32_t),
+            .storage_size = sizeof (shard_data[0]),
+            .index_mask = SHARD_ELEMENTS - 1,
+            .storage = shard_data[0]
+        }
+    };
+    rl_ringbuffer_sharded_t lock_free = {.shards = unlocked, .shard_count = 1};
+    rl_ringbuffer_sharded_t no_shards = {.shards = shards, .shard_count = 0};
+    uint32_t data = 0;
+    size_t count = 1;
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_sharded_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_sharded_init (&lock_free));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_sharded_init (&no_shards));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_sharded_queue (&queue, SHARDS,
+                 &data, sizeof (data)));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_sharded_dequeue_n (&queue, SHARDS,
+                 &data, &count));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_sharded_dequeue_n (&queue, 0, NULL,
+                 &count));
+    count = 0;
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_sharded_dequeue_n (&queue, 0,
+                 &data, &count));
+}
+
+static void * producer (void * arg)
+{
+    worker_t * const p_worker = (worker_t *) arg;
+    const size_t shard = p_worker->index % p_worker->queue->shard_count;
+
+    for (uint32_t ii = 0; ii < p_worker->count; ii++)
+    {
+        const uint32_t value = (p_worker->index << PRODUCER_SHIFT) | ii;
+
+        while (RL_SUCCESS != rl_ringbuffer_sharded_queue (p_worker->queue, shard, &value,
+                sizeof (value)))
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void * consumer (void * arg)
+{
+    worker_t * const p_worker = (worker_t *) arg;
+    const size_t shard = p_worker->index % p_worker->queue->shard_count;
+    int64_t last[SHARDS];
+    uint32_t data[BATCH];
+
+    for (size_t ii = 0; ii < SHARDS; ii++)
+    {
+        last[ii] = -1;
+    }
+
+    while (atomic_load (&m_consumed) < BENCH_ELEMENTS)
+    {
+        size_t count = BATCH;
+
+        if (RL_SUCCESS != rl_ringbuffer_sharded_dequeue_n (p_worker->queue, shard, data,
+                &count))
+        {
+            sched_yield();
+            continue;
+        }
+
+        for (size_t ii = 0; ii < count; ii++)
+        {
+            const uint32_t producer_index = data[ii] >> PRODUCER_SHIFT;
+            const int64_t sequence = data[ii] & ( (1U << PRODUCER_SHIFT) - 1U);
+            // Consumer sees each producer's elements in increasing order.
+            p_worker->errors += (sequence <= last[producer_index]);
+            last[producer_index] = sequence;
+            p_worker->sum += sequence;
+        }
+
+        p_worker->count += count;
+        atomic_fetch_add (&m_consumed, (uint32_t) count);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Move BENCH_ELEMENTS from cores producers to cores consumers.
+ *
+ * @param[in] shard_count 1 to share one locked ringbuffer, cores for a shard per core.
+ * @return true if every value was consumed exactly once in producer order.
+ */
+static bool bench_run (const uint32_t cores, const size_t shard_count)
+{
+    rl_ringbuffer_sharded_t bench_queue = {.shards = shards, .shard_count = shard_count};
+    pthread_t threads[2 * SHARDS];
+    worker_t workers[2 * SHARDS] = {0};
+    const uint32_t per_producer = BENCH_ELEMENTS / cores;
+    const uint32_t total = per_producer * cores;
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    uint32_t errors = 0;
+    struct timespec start;
+    struct timespec end;
+    setUp();
+    // Consumers stop once they have the total, remainder of division is never produced.
+    atomic_store (&m_consumed, BENCH_ELEMENTS - total);
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    for (uint32_t ii = 0; ii < 2 * cores; ii++)
+    {
+        workers[ii].queue = &bench_queue;
+        workers[ii].index = ii % cores;
+        workers[ii].count = (ii < cores) ? per_producer : 0;
+        pthread_create (&threads[ii], NULL, (ii < cores) ? &producer : &consumer,
+                        &workers[ii]);
+    }
+
+    for (uint32_t ii = 0; ii < 2 * cores; ii++)
+    {
+        pthread_join (threads[ii], NULL);
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &end);
+
+    for (uint32_t ii = cores; ii < 2 * cores; ii++)
+    {
+        sum += workers[ii].sum;
+        count += workers[ii].count;
+        errors += workers[ii].errors;
+    }
+
+    const double elapsed = (end.tv_sec - start.tv_sec)
+                           + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+    printf ("%s, %u cores: %.1f M elements / s\n", (1 == shard_count) ? "single " : "sharded",
+            cores, (total / elapsed) / 1e6);
+    return (0 == errors) && (count == total)
+           && (sum == (uint64_t) cores * ( ( (uint64_t) per_producer * (per_producer - 1U)) / 2U));
+}
+
+void test_ruuvi_library_ringbuffer_sharded_scaling (void)
+{
+    for (uint32_t cores = 1; cores <= SHARDS; cores *= 2)
+    {
+        TEST_ASSERT (bench_run (cores, 1));
+        TEST_ASSERT (bench_run (cores, cores));
+    }
+}
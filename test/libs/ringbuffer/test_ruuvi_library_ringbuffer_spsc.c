@@ -0,0 +1,622 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_ringbuffer.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define STRESS_ELEMENTS (1000000U) //!< Number of elements pushed through buffer in stress test.
+#define PING_PONG_ROUNDS (200000U) //!< Number of round trips in ping-pong benchmark.
+#define WAIT_ELEMENTS (4096U) //!< Number of elements passed to a blocking consumer.
+#define WAIT_BATCH (8U) //!< Number of elements blocking consumer waits for.
+#define WAIT_TIMEOUT_MS (10U) //!< Timeout of wait which is expected to expire.
+#define WAIT_LONG_MS (400U)   //!< Timeout of wait which is expected to succeed early.
+
+/**
+ * @brief Thread-safe try-lock for the locked reference path.
+ */
+static bool flag (volatile uint32_t * const flag, const bool lock)
+{
+    _Atomic uint32_t * p_flag = (_Atomic uint32_t *) flag;
+
+    if (lock)
+    {
+        uint32_t expected = 0;
+        return atomic_compare_exchange_strong (p_flag, &expected, 1U);
+    }
+
+    atomic_store (p_flag, 0U);
+    return true;
+}
+
+static uint32_t buffer_data[256] = {0};
+static _Atomic uint32_t buffer_wlock = 0;
+static _Atomic uint32_t buffer_rlock = 0;
+static rl_ringbuffer_t spsc_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL
+};
+static rl_ringbuffer_t locked_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .lock = flag,
+    .writelock = &buffer_wlock,
+    .readlock  = &buffer_rlock
+};
+
+static rl_ringbuffer_t overwrite_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (buffer_data[0]),
+    .storage_size = sizeof (buffer_data),
+    .index_mask = (sizeof (buffer_data) / sizeof (buffer_data[0])) - 1,
+    .storage = buffer_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL,
+    .policy = RL_RINGBUFFER_POLICY_OVERWRITE
+};
+
+static uint32_t pong_data[256] = {0};
+static rl_ringbuffer_t pong_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (pong_data[0]),
+    .storage_size = sizeof (pong_data),
+    .index_mask = (sizeof (pong_data) / sizeof (pong_data[0])) - 1,
+    .storage = pong_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL
+};
+
+/**
+ * @brief Condition variable backend for blocking consumers.
+ */
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    _Atomic uint32_t notifications; //!< Number of notify calls, for statistics.
+} cond_waiter_t;
+
+static cond_waiter_t cond_waiter =
+{
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .notifications = 0
+};
+
+static rl_status_t cond_wait (void * const context, _Atomic uint32_t * const word,
+                              const uint32_t expected, const uint32_t timeout_ms)
+{
+    cond_waiter_t * const p_waiter = (cond_waiter_t *) context;
+    struct timespec deadline;
+    int rc = 0;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000U;
+    deadline.tv_nsec += (timeout_ms % 1000U) * 1000000L;
+
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock (&p_waiter->mutex);
+
+    // Word is compared under the mutex so that notify cannot slip in before sleep.
+    while ( (expected == atomic_load (word)) && (0 == rc))
+    {
+        rc = pthread_cond_timedwait (&p_waiter->cond, &p_waiter->mutex, &deadline);
+    }
+
+    pthread_mutex_unlock (&p_waiter->mutex);
+    return (ETIMEDOUT == rc) ? RL_ERROR_NO_DATA : RL_SUCCESS;
+}
+
+static void cond_notify (void * const context, _Atomic uint32_t * const word)
+{
+    cond_waiter_t * const p_waiter = (cond_waiter_t *) context;
+    (void) word;
+    atomic_fetch_add (&p_waiter->notifications, 1U);
+    pthread_mutex_lock (&p_waiter->mutex);
+    pthread_cond_broadcast (&p_waiter->cond);
+    pthread_mutex_unlock (&p_waiter->mutex);
+}
+
+static uint32_t monotonic_ms (void * const context)
+{
+    struct timespec now;
+    (void) context;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint32_t) ( (now.tv_sec * 1000U) + (now.tv_nsec / 1000000L));
+}
+
+static const rl_ringbuffer_waiter_t waiter =
+{
+    .wait = cond_wait,
+    .notify = cond_notify,
+    .now_ms = monotonic_ms,
+    .context = &cond_waiter
+};
+
+static uint32_t wait_data[64] = {0};
+static rl_ringbuffer_t wait_ringbuf =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (wait_data[0]),
+    .storage_size = sizeof (wait_data),
+    .index_mask = (sizeof (wait_data) / sizeof (wait_data[0])) - 1,
+    .storage = wait_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock  = NULL,
+    .waiter = &waiter
+};
+
+void setUp (void)
+{
+    buffer_wlock = 0;
+    buffer_rlock = 0;
+    memset (buffer_data, 0, sizeof (buffer_data));
+    rl_ringbuffer_reset (&spsc_ringbuf);
+    rl_ringbuffer_reset (&locked_ringbuf);
+    rl_ringbuffer_reset (&overwrite_ringbuf);
+    rl_ringbuffer_reset (&pong_ringbuf);
+    rl_ringbuffer_reset (&wait_ringbuf);
+    cond_waiter.notifications = 0;
+}
+
+void tearDown (void)
+{
+}
+
+static void * producer (void * arg)
+{
+    rl_ringbuffer_t * const p_buf = (rl_ringbuffer_t *) arg;
+
+    for (uint32_t ii = 0; ii < STRESS_ELEMENTS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_queue (p_buf, &ii, sizeof (ii)))
+        {
+            // Full or contended, let consumer run.
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Push STRESS_ELEMENTS through buffer from a producer thread.
+ *
+ * @return Number of elements which were received out of order.
+ */
+static uint32_t stress_run (rl_ringbuffer_t * const p_buf, const char * const name)
+{
+    pthread_t thread;
+    uint32_t errors = 0;
+    uint32_t * p_data = NULL;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    pthread_create (&thread, NULL, &producer, p_buf);
+
+    for (uint32_t ii = 0; ii < STRESS_ELEMENTS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_dequeue (p_buf, &p_data))
+        {
+            // Empty or contended, let producer run.
+            sched_yield();
+        }
+
+        errors += (*p_data != ii);
+    }
+
+    pthread_join (thread, NULL);
+    clock_gettime (CLOCK_MONOTONIC, &end);
+    const double elapsed = (end.tv_sec - start.tv_sec)
+                           + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+    printf ("%s: %.1f M elements / s\n", name, (STRESS_ELEMENTS / elapsed) / 1e6);
+    return errors;
+}
+
+void test_ruuvi_library_ringbuffer_spsc_queue_dequeue (void)
+{
+    uint32_t data = 0xAABBCCDDU;
+    uint32_t * p_readback = NULL;
+    TEST_ASSERT (rl_ringbuffer_empty (&spsc_ringbuf));
+    rl_status_t lib_status = rl_ringbuffer_queue (&spsc_ringbuf, &data, sizeof (data));
+    TEST_ASSERT (!rl_ringbuffer_empty (&spsc_ringbuf));
+    lib_status |= rl_ringbuffer_peek (&spsc_ringbuf, &p_readback, 0);
+    TEST_ASSERT (*p_readback == data);
+    lib_status |= rl_ringbuffer_dequeue (&spsc_ringbuf, &p_readback);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (*p_readback == data);
+    TEST_ASSERT (rl_ringbuffer_empty (&spsc_ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_spsc_overfill (void)
+{
+    uint32_t data = 0;
+    rl_status_t lib_status = RL_SUCCESS;
+    size_t queued = 0;
+
+    while (RL_SUCCESS == lib_status)
+    {
+        lib_status = rl_ringbuffer_queue (&spsc_ringbuf, &data, sizeof (data));
+        queued += (RL_SUCCESS == lib_status);
+    }
+
+    TEST_ASSERT (RL_ERROR_NO_MEM == lib_status);
+    TEST_ASSERT (spsc_ringbuf.index_mask == queued);
+    TEST_ASSERT (rl_ringbuffer_full (&spsc_ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_spsc_stress (void)
+{
+    TEST_ASSERT (0 == stress_run (&spsc_ringbuf, "spsc"));
+    TEST_ASSERT (rl_ringbuffer_empty (&spsc_ringbuf));
+}
+
+void test_ruuvi_library_ringbuffer_locked_stress (void)
+{
+    TEST_ASSERT (0 == stress_run (&locked_ringbuf, "locked"));
+    TEST_ASSERT (rl_ringbuffer_empty (&locked_ringbuf));
+}
+
+static void * overwrite_producer (void * arg)
+{
+    uint32_t * const p_errors = (uint32_t *) arg;
+
+    for (uint32_t ii = 0; ii < STRESS_ELEMENTS; ii++)
+    {
+        // Producer never has to wait for consumer.
+        *p_errors += (RL_SUCCESS != rl_ringbuffer_queue (&overwrite_ringbuf, &ii,
+                      sizeof (ii)));
+
+        if (0 == (ii % 1024)) { sched_yield(); }
+    }
+
+    return NULL;
+}
+
+void test_ruuvi_library_ringbuffer_spsc_overwrite_stress (void)
+{
+    pthread_t thread;
+    uint32_t readback[16] = {0};
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint32_t queue_errors = 0;
+    uint32_t previous = 0;
+    bool first = true;
+    pthread_create (&thread, NULL, &overwrite_producer, &queue_errors);
+
+    // Sequence must stay increasing, gaps are dropped elements.
+    while (first || (previous + 1) < STRESS_ELEMENTS)
+    {
+        size_t count = sizeof (readback) / sizeof (readback[0]);
+
+        if (RL_SUCCESS != rl_ringbuffer_dequeue_n (&overwrite_ringbuf, readback, &count))
+        {
+            sched_yield();
+            continue;
+        }
+
+        for (size_t ii = 0; ii < count; ii++)
+        {
+            errors += (!first && (readback[ii] <= previous));
+            previous = readback[ii];
+            first = false;
+        }
+
+        received += count;
+    }
+
+    pthread_join (thread, NULL);
+    TEST_ASSERT (0 == errors);
+    TEST_ASSERT (0 == queue_errors);
+    TEST_ASSERT (STRESS_ELEMENTS == (received + overwrite_ringbuf.dropped));
+}
+
+void test_ruuvi_library_ringbuffer_spsc_overwrite_tail_unique (void)
+{
+    const size_t slots = overwrite_ringbuf.index_mask + 1;
+    uint32_t readback[4] = {0};
+    size_t count = sizeof (readback) / sizeof (readback[0]);
+    rl_status_t lib_status = RL_SUCCESS;
+
+    for (uint32_t ii = 0; ii < overwrite_ringbuf.index_mask; ii++)
+    {
+        lib_status |= rl_ringbuffer_queue (&overwrite_ringbuf, &ii, sizeof (ii));
+    }
+
+    // Consumer preempted here would compare against this tail.
+    const size_t tail = atomic_load (&overwrite_ringbuf.tail);
+
+    for (uint32_t ii = 0; ii < slots; ii++)
+    {
+        lib_status |= rl_ringbuffer_queue (&overwrite_ringbuf, &ii, sizeof (ii));
+    }
+
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (slots == overwrite_ringbuf.dropped);
+    // Same slot of storage, but not the same tail.
+    TEST_ASSERT ( (tail & overwrite_ringbuf.index_mask)
+                  == (atomic_load (&overwrite_ringbuf.tail) & overwrite_ringbuf.index_mask));
+    TEST_ASSERT (tail != atomic_load (&overwrite_ringbuf.tail));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_dequeue_n (&overwrite_ringbuf, readback, &count));
+    TEST_ASSERT (1 == readback[0]);
+}
+
+static void * echo (void * arg)
+{
+    (void) arg;
+    uint32_t * p_data = NULL;
+
+    for (uint32_t ii = 0; ii < PING_PONG_ROUNDS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_dequeue (&spsc_ringbuf, &p_data))
+        {
+            sched_yield();
+        }
+
+        const uint32_t value = *p_data + 1;
+
+        while (RL_SUCCESS != rl_ringbuffer_queue (&pong_ringbuf, &value, sizeof (value)))
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+void test_ruuvi_library_ringbuffer_cache_line_layout (void)
+{
+#if RL_RINGBUFFER_CACHE_LINE_SIZE
+    // Producer and consumer indices must not share a cache line.
+    TEST_ASSERT ( (offsetof (rl_ringbuffer_t, tail) - offsetof (rl_ringbuffer_t, head))
+                  >= RL_RINGBUFFER_CACHE_LINE_SIZE);
+    TEST_ASSERT ( (offsetof (rl_ringbuffer_t, block_size) - offsetof (rl_ringbuffer_t, tail))
+                  >= RL_RINGBUFFER_CACHE_LINE_SIZE);
+    TEST_ASSERT (0 == ( (uintptr_t) &spsc_ringbuf % RL_RINGBUFFER_CACHE_LINE_SIZE));
+#else
+    // Compact layout doesn't over-align the blocks.
+    TEST_ASSERT (_Alignof (rl_ringbuffer_t) == _Alignof (size_t));
+#endif
+}
+
+/**
+ * @brief Bounce a counter between two threads through two lock-free buffers.
+ *
+ * Every round trip crosses cores twice on a multicore host, so the time is dominated by
+ * cache line transfers of head and tail. Compare runs with and without
+ * RL_RINGBUFFER_CACHE_LINE_SIZE.
+ */
+void test_ruuvi_library_ringbuffer_ping_pong (void)
+{
+    pthread_t thread;
+    uint32_t errors = 0;
+    uint32_t * p_data = NULL;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    pthread_create (&thread, NULL, &echo, NULL);
+
+    for (uint32_t ii = 0; ii < PING_PONG_ROUNDS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_queue (&spsc_ringbuf, &ii, sizeof (ii)))
+        {
+            sched_yield();
+        }
+
+        while (RL_SUCCESS != rl_ringbuffer_dequeue (&pong_ringbuf, &p_data))
+        {
+            sched_yield();
+        }
+
+        errors += (*p_data != (ii + 1));
+    }
+
+    pthread_join (thread, NULL);
+    clock_gettime (CLOCK_MONOTONIC, &end);
+    const double elapsed = (end.tv_sec - start.tv_sec)
+                           + ( (end.tv_nsec - start.tv_nsec) / 1e9);
+    printf ("ping-pong, cache line %u: %.2f M round trips / s\n",
+            (unsigned) RL_RINGBUFFER_CACHE_LINE_SIZE, (PING_PONG_ROUNDS / elapsed) / 1e6);
+    TEST_ASSERT (0 == errors);
+}
+
+void test_ruuvi_library_ringbuffer_wait_timeout (void)
+{
+    uint32_t readback[WAIT_BATCH] = {0};
+    size_t count = WAIT_BATCH;
+    rl_status_t lib_status = rl_ringbuffer_dequeue_wait (&wait_ringbuf, readback, &count,
+                             WAIT_TIMEOUT_MS);
+    TEST_ASSERT (RL_ERROR_NO_DATA == lib_status);
+    TEST_ASSERT (0 == count);
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_ringbuffer_wait (&wait_ringbuf, 1, WAIT_TIMEOUT_MS));
+}
+
+void test_ruuvi_library_ringbuffer_wait_partial_batch (void)
+{
+    uint32_t data[2] = {1, 2};
+    uint32_t readback[WAIT_BATCH] = {0};
+    size_t count = WAIT_BATCH;
+    rl_status_t lib_status = rl_ringbuffer_queue_n (&wait_ringbuf, data, 2);
+    lib_status |= rl_ringbuffer_dequeue_wait (&wait_ringbuf, readback, &count,
+                  WAIT_TIMEOUT_MS);
+    TEST_ASSERT (RL_SUCCESS == lib_status);
+    TEST_ASSERT (2 == count);
+    TEST_ASSERT_EQUAL_MEMORY (data, readback, sizeof (data));
+    // Nobody was waiting for two elements, producer must not have called notify.
+    TEST_ASSERT (0 == cond_waiter.notifications);
+}
+
+void test_ruuvi_library_ringbuffer_wait_invalid_count (void)
+{
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_wait (&wait_ringbuf, 0, 0));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_wait (&wait_ringbuf,
+                 wait_ringbuf.index_mask + 1, 0));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_wait (&spsc_ringbuf, 1, 0));
+}
+
+static void * slow_producer (void * arg)
+{
+    (void) arg;
+
+    for (uint32_t ii = 0; ii < WAIT_ELEMENTS; ii++)
+    {
+        while (RL_SUCCESS != rl_ringbuffer_queue (&wait_ringbuf, &ii, sizeof (ii)))
+        {
+            sched_yield();
+        }
+
+        // Trickle elements in so that consumer really has to sleep.
+        if (0 == (ii % 3))
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+void test_ruuvi_library_ringbuffer_wait_threshold (void)
+{
+    pthread_t thread;
+    uint32_t readback[WAIT_BATCH] = {0};
+    uint32_t errors = 0;
+    uint32_t batches = 0;
+    uint32_t expected = 0;
+    pthread_create (&thread, NULL, &slow_producer, NULL);
+
+    while (expected < WAIT_ELEMENTS)
+    {
+        size_t count = WAIT_BATCH;
+        // Long timeout, every batch must complete.
+        rl_status_t lib_status = rl_ringbuffer_dequeue_wait (&wait_ringbuf, readback,
+                                 &count, 1000U);
+        errors += (RL_SUCCESS != lib_status) || (WAIT_BATCH != count);
+
+        for (size_t ii = 0; ii < count; ii++)
+        {
+            errors += (readback[ii] != expected++);
+        }
+
+        batches++;
+    }
+
+    pthread_join (thread, NULL);
+    TEST_ASSERT (0 == errors);
+    TEST_ASSERT ( (WAIT_ELEMENTS / WAIT_BATCH) == batches);
+    // Producer wakes consumer per batch rather than per element. Each wait publishes
+    // the threshold at most twice, once before sleeping and once after waking.
+    TEST_ASSERT (cond_waiter.notifications <= (2U * batches));
+    TEST_ASSERT (rl_ringbuffer_empty (&wait_ringbuf));
+}
+
+typedef struct
+{
+    size_t count;       //!< Number of elements to wait for.
+    rl_status_t status; //!< Result of wait.
+    uint32_t elapsed;   //!< Time spent in wait, ms.
+} wait_job_t;
+
+static void * waiting_consumer (void * arg)
+{
+    wait_job_t * const p_job = (wait_job_t *) arg;
+    const uint32_t start = monotonic_ms (NULL);
+    p_job->status = rl_ringbuffer_wait (&wait_ringbuf, p_job->count, WAIT_LONG_MS);
+    p_job->elapsed = monotonic_ms (NULL) - start;
+    return NULL;
+}
+
+static void threshold_await (const size_t threshold)
+{
+    while (threshold != atomic_load (&wait_ringbuf.wake_threshold))
+    {
+        sched_yield();
+    }
+}
+
+void test_ruuvi_library_ringbuffer_wait_mixed_counts (void)
+{
+    pthread_t threads[2];
+    wait_job_t jobs[2] = {{.count = 1}, {.count = WAIT_BATCH}};
+    uint32_t data[WAIT_BATCH] = {0};
+    // Small count waits first, larger count arriving later must not hide it.
+    pthread_create (&threads[0], NULL, &waiting_consumer, &jobs[0]);
+    threshold_await (1);
+    pthread_create (&threads[1], NULL, &waiting_consumer, &jobs[1]);
+    // Let second consumer publish its count and sleep.
+    struct timespec pause = {.tv_sec = 0, .tv_nsec = 20000000L};
+    nanosleep (&pause, NULL);
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_queue (&wait_ringbuf, &data[0],
+                 sizeof (data[0])));
+    pthread_join (threads[0], NULL);
+    TEST_ASSERT (RL_SUCCESS == jobs[0].status);
+    TEST_ASSERT (jobs[0].elapsed < (WAIT_LONG_MS / 2U));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_queue_n (&wait_ringbuf, &data[1],
+                 WAIT_BATCH - 1U));
+    pthread_join (threads[1], NULL);
+    TEST_ASSERT (RL_SUCCESS == jobs[1].status);
+    TEST_ASSERT (jobs[1].elapsed < (WAIT_LONG_MS / 2U));
+}
+
+static void * spurious_waker (void * arg)
+{
+    _Atomic bool * const p_done = (_Atomic bool *) arg;
+    struct timespec pause = {.tv_sec = 0, .tv_nsec = (WAIT_LONG_MS / 4U) * 1000000L};
+
+    // Bounded, so that a wait which restarts its timeout fails instead of hanging.
+    for (uint32_t ii = 0; (ii < 8U) && !atomic_load (p_done); ii++)
+    {
+        nanosleep (&pause, NULL);
+        atomic_fetch_add (&wait_ringbuf.wake_seq, 1U);
+        cond_notify (&cond_waiter, &wait_ringbuf.wake_seq);
+    }
+
+    return NULL;
+}
+
+void test_ruuvi_library_ringbuffer_wait_spurious_keeps_deadline (void)
+{
+    pthread_t thread;
+    _Atomic bool done = false;
+    wait_job_t job = {.count = 1};
+    pthread_create (&thread, NULL, &spurious_waker, &done);
+    waiting_consumer (&job);
+    atomic_store (&done, true);
+    pthread_join (thread, NULL);
+    // Restarting the timeout on every wakeup would never expire.
+    TEST_ASSERT (RL_ERROR_NO_DATA == job.status);
+    TEST_ASSERT (job.elapsed >= WAIT_LONG_MS);
+    TEST_ASSERT (job.elapsed < (2U * WAIT_LONG_MS));
+}
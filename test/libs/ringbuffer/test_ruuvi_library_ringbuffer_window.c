@@ -0,0 +1,163 @@
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_ringbuffer.h"
+#include "ruuvi_library_ringbuffer_window.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_variance.h"
+
+#include <math.h>
+#include <string.h>
+
+#define WINDOW_LENGTH (50U) //!< Samples in full window.
+#define STREAM_LENGTH (1000U) //!< Samples pushed in comparison tests.
+
+static float sample_data[64] = {0};
+static rl_ringbuffer_t samples =
+{
+    .head = 0,
+    .tail = 0,
+    .block_size = sizeof (sample_data[0]),
+    .storage_size = sizeof (sample_data),
+    .index_mask = (sizeof (sample_data) / sizeof (sample_data[0])) - 1,
+    .storage = sample_data,
+    .lock = NULL,
+    .writelock = NULL,
+    .readlock = NULL
+};
+static rl_peak2peak_extremum_t mins[WINDOW_LENGTH];
+static rl_peak2peak_extremum_t maxs[WINDOW_LENGTH];
+static rl_ringbuffer_window_t window =
+{
+    .samples = &samples,
+    .length = WINDOW_LENGTH,
+    .extrema = {.length = WINDOW_LENGTH, .min = {.items = mins}, .max = {.items = maxs}}
+};
+static float stream[STREAM_LENGTH];
+
+void setUp (void)
+{
+    memset (sample_data, 0, sizeof (sample_data));
+    rl_ringbuffer_window_init (&window);
+
+    // Pressure-like signal with a large offset, noise and occasional steps.
+    for (size_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        stream[ii] = 101325.0F + (10.0F * sinf (ii * 0.1F)) + (float) ( (ii * 7919U) % 13U)
+                     + (float) ( (ii / 200U) * 50U);
+    }
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * @brief Tolerance for comparison against batch functions, relative to magnitude.
+ */
+static float tolerance (const float expected)
+{
+    return 1e-3F + (1e-4F * fabsf (expected));
+}
+
+void test_ruuvi_library_ringbuffer_window_matches_batch (void)
+{
+    for (size_t ii = 0; ii < STREAM_LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, stream[ii]));
+        const size_t count = (ii < WINDOW_LENGTH) ? ii + 1 : WINDOW_LENGTH;
+        const float * const p_window = &stream[ii + 1 - count];
+        const float rms = rl_rms (p_window, count);
+        const float variance = rl_variance (p_window, count);
+        const float peak2peak = rl_peak2peak (p_window, count);
+        TEST_ASSERT (count == rl_ringbuffer_count (&samples));
+        TEST_ASSERT_FLOAT_WITHIN (tolerance (rms), rms, rl_ringbuffer_window_rms (&window));
+        TEST_ASSERT_FLOAT_WITHIN (tolerance (variance), variance,
+                                  rl_ringbuffer_window_variance (&window));
+        TEST_ASSERT_EQUAL_FLOAT (peak2peak, rl_ringbuffer_window_peak2peak (&window));
+    }
+}
+
+void test_ruuvi_library_ringbuffer_window_extrema_leave_window (void)
+{
+    // Descending then ascending, every sample becomes minimum or maximum in turn.
+    for (size_t ii = 0; ii < 3 * WINDOW_LENGTH; ii++)
+    {
+        const float value = (ii < WINDOW_LENGTH) ? (float) (WINDOW_LENGTH - ii) : (float) ii;
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, value));
+    }
+
+    // Window holds 2 * WINDOW_LENGTH ... 3 * WINDOW_LENGTH - 1.
+    TEST_ASSERT_EQUAL_FLOAT (WINDOW_LENGTH - 1, rl_ringbuffer_window_peak2peak (&window));
+    TEST_ASSERT_EQUAL_FLOAT (2.5F * WINDOW_LENGTH - 0.5F, rl_ringbuffer_window_mean (&window));
+}
+
+void test_ruuvi_library_ringbuffer_window_constant (void)
+{
+    for (size_t ii = 0; ii < 3 * WINDOW_LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, 101325.0F));
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_ringbuffer_window_variance (&window));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_ringbuffer_window_peak2peak (&window));
+    TEST_ASSERT_EQUAL_FLOAT (101325.0F, rl_ringbuffer_window_rms (&window));
+}
+
+void test_ruuvi_library_ringbuffer_window_nan_leaves_window (void)
+{
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, 1.0F));
+    TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, NAN));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_rms (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_variance (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_peak2peak (&window)));
+
+    for (size_t ii = 0; ii < WINDOW_LENGTH; ii++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_ringbuffer_window_push (&window, 3.0F));
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT (3.0F, rl_ringbuffer_window_rms (&window));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_ringbuffer_window_peak2peak (&window));
+}
+
+void test_ruuvi_library_ringbuffer_window_empty (void)
+{
+    TEST_ASSERT (isnan (rl_ringbuffer_window_mean (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_rms (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_variance (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_peak2peak (&window)));
+    TEST_ASSERT (isnan (rl_ringbuffer_window_rms (NULL)));
+}
+
+void test_ruuvi_library_ringbuffer_window_invalid (void)
+{
+    rl_ringbuffer_window_t too_long =
+    {
+        .samples = &samples,
+        .length = sizeof (sample_data) / sizeof (sample_data[0]),
+        .extrema = {
+            .length = sizeof (sample_data) / sizeof (sample_data[0]),
+            .min = {.items = mins}, .max = {.items = maxs}
+        }
+    };
+    rl_ringbuffer_window_t no_deque =
+    {
+        .samples = &samples,
+        .length = WINDOW_LENGTH,
+        .extrema = {.length = WINDOW_LENGTH, .min = {.items = mins}, .max = {.items = NULL}}
+    };
+    rl_ringbuffer_window_t mismatch =
+    {
+        .samples = &samples,
+        .length = WINDOW_LENGTH,
+        .extrema = {.length = WINDOW_LENGTH - 1, .min = {.items = mins}, .max = {.items = maxs}}
+    };
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_window_init (NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_window_init (&no_deque));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_window_init (&too_long));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_ringbuffer_window_init (&mismatch));
+    TEST_ASSERT (RL_ERROR_NULL == rl_ringbuffer_window_push (NULL, 1.0F));
+}
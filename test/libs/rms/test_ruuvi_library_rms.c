@@ -1,6 +1,7 @@
 #include "unity.h"
 
 #include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
 
 #include <math.h>
 
@@ -50,3 +51,44 @@ void test_ruuvi_library_rms_nan_input (void)
                            sizeof (nan_test_vector) / sizeof (nan_test_vector[0]));
     TEST_ASSERT (isnan (result));
 }
+
+const int16_t valid_i16_vector[] = {0, 1, -1, 50, 25};
+const int32_t valid_i32_vector[] = {0, 1, -1, 50, 25};
+
+void test_ruuvi_library_rms_i16_ok (void)
+{
+    TEST_ASSERT_EQUAL_FLOAT (vtv_rms, rl_rms_i16 (valid_i16_vector, 5));
+    TEST_ASSERT_EQUAL_FLOAT (rl_rms (valid_test_vector, 5), rl_rms_i16 (valid_i16_vector, 5));
+}
+
+void test_ruuvi_library_rms_i16_full_scale (void)
+{
+    const int16_t full_scale[] = {INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN};
+    TEST_ASSERT_EQUAL_FLOAT (32768.0F, rl_rms_i16 (full_scale, 4));
+}
+
+void test_ruuvi_library_rms_i32_ok (void)
+{
+    const int32_t full_scale[] = {INT32_MIN, INT32_MIN};
+    TEST_ASSERT_EQUAL_FLOAT (vtv_rms, rl_rms_i32 (valid_i32_vector, 5));
+    TEST_ASSERT_EQUAL_FLOAT (2147483648.0F, rl_rms_i32 (full_scale, 2));
+}
+
+void test_ruuvi_library_rms_integer_invalid (void)
+{
+    TEST_ASSERT (isnan (rl_rms_i16 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_rms_i16 (valid_i16_vector, 0)));
+    TEST_ASSERT (isnan (rl_rms_i32 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_rms_i32 (valid_i32_vector, 0)));
+}
+
+void test_ruuvi_library_rms_strided (void)
+{
+    // Every second value of interleaved pairs is the valid test vector.
+    const float interleaved[] = {0.0F, NAN, 1.0F, NAN, -1.0F, NAN, 50.0F, NAN, 25.0F};
+    TEST_ASSERT_EQUAL_FLOAT (vtv_rms, rl_rms_strided (interleaved, 5, 2));
+    TEST_ASSERT (isnan (rl_rms_strided (&interleaved[1], 4, 2)));
+    TEST_ASSERT (rl_rms (valid_test_vector, 5) == rl_rms_strided (valid_test_vector, 5, 1));
+    TEST_ASSERT (isnan (rl_rms_strided (valid_test_vector, 5, 0)));
+    TEST_ASSERT (isnan (rl_rms_strided (NULL, 5, 2)));
+}
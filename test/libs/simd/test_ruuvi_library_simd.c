@@ -0,0 +1,356 @@
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_variance.h"
+
+#include <float.h>
+#include <math.h>
+
+#define MAX_LENGTH (67U)  //!< Covers several vectors of every width plus odd tails.
+#define LONG_LENGTH (100000U) //!< Samples in accuracy comparison.
+#define HUGE_LENGTH (2000003U) //!< Samples in pairwise accuracy test, not whole blocks.
+#define STRIDED_LENGTH (1000001U) //!< Samples in strided accuracy test, fits stride 2.
+
+static float vector[MAX_LENGTH];
+static float long_vector[LONG_LENGTH];
+static float huge_vector[HUGE_LENGTH];
+static float strided_source[STRIDED_LENGTH];
+static int16_t counts[HUGE_LENGTH];
+static rl_simd_level_t m_detected;
+
+void setUp (void)
+{
+    static bool detected = false;
+
+    if (!detected)
+    {
+        m_detected = rl_simd_level();
+        detected = true;
+    }
+
+    for (size_t ii = 0; ii < MAX_LENGTH; ii++)
+    {
+        vector[ii] = ( (float) ( (ii * 7919U) % 101U) - 50.0F) * 0.37F;
+    }
+
+    for (size_t ii = 0; ii < LONG_LENGTH; ii++)
+    {
+        long_vector[ii] = 20.0F + sinf (ii * 0.001F) + ( (float) ( (ii * 31U) % 17U) * 0.01F);
+    }
+}
+
+void tearDown (void)
+{
+    rl_simd_select (m_detected);
+    rl_simd_accumulation_select (RL_SIMD_ACCUMULATE_PAIRWISE);
+}
+
+/**
+ * @brief Run check over every level compiled in and supported by CPU.
+ *
+ * @return Number of levels checked.
+ */
+static size_t for_each_level (void (*check) (const rl_simd_level_t level))
+{
+    size_t checked = 0;
+
+    for (int level = RL_SIMD_SCALAR; level <= RL_SIMD_NEON; level++)
+    {
+        if (RL_SUCCESS == rl_simd_select ( (rl_simd_level_t) level))
+        {
+            check ( (rl_simd_level_t) level);
+            checked++;
+        }
+    }
+
+    return checked;
+}
+
+static void check_lengths (const rl_simd_level_t level)
+{
+    (void) level;
+
+    for (size_t length = 1; length <= MAX_LENGTH; length++)
+    {
+        float sum = 0;
+        float square_sum = 0;
+        float min = 0;
+        float max = 0;
+        float expected_sum = 0;
+        float expected_square_sum = 0;
+        float expected_min = vector[0];
+        float expected_max = vector[0];
+
+        for (size_t ii = 0; ii < length; ii++)
+        {
+            expected_sum += vector[ii];
+            expected_square_sum += vector[ii] * vector[ii];
+            expected_min = fminf (expected_min, vector[ii]);
+            expected_max = fmaxf (expected_max, vector[ii]);
+        }
+
+        TEST_ASSERT (rl_simd_sum (vector, length, &sum));
+        TEST_ASSERT (rl_simd_square_sum (vector, length, &square_sum));
+        TEST_ASSERT (rl_simd_min_max (vector, length, &min, &max));
+        // Reassociated sum of mixed signs, bound relative to sum of magnitudes.
+        TEST_ASSERT_FLOAT_WITHIN (length * FLT_EPSILON * 20.0F * length, expected_sum, sum);
+        TEST_ASSERT_FLOAT_WITHIN (length * FLT_EPSILON * expected_square_sum,
+                                  expected_square_sum, square_sum);
+        TEST_ASSERT (expected_min == min);
+        TEST_ASSERT (expected_max == max);
+    }
+}
+
+void test_ruuvi_library_simd_lengths (void)
+{
+    TEST_ASSERT (0 < for_each_level (&check_lengths));
+}
+
+static void check_non_finite (const rl_simd_level_t level)
+{
+    (void) level;
+    const float bad[] = {NAN, INFINITY, -INFINITY};
+
+    for (size_t kind = 0; kind < (sizeof (bad) / sizeof (bad[0])); kind++)
+    {
+        for (size_t position = 0; position < MAX_LENGTH; position++)
+        {
+            float result = 0;
+            float other = 0;
+            const float saved = vector[position];
+            vector[position] = bad[kind];
+            TEST_ASSERT (!rl_simd_sum (vector, MAX_LENGTH, &result));
+            TEST_ASSERT (!rl_simd_square_sum (vector, MAX_LENGTH, &result));
+            TEST_ASSERT (!rl_simd_min_max (vector, MAX_LENGTH, &result, &other));
+            TEST_ASSERT (isnan (rl_rms (vector, MAX_LENGTH)));
+            TEST_ASSERT (isnan (rl_variance (vector, MAX_LENGTH)));
+            TEST_ASSERT (isnan (rl_peak2peak (vector, MAX_LENGTH)));
+            vector[position] = saved;
+        }
+    }
+}
+
+void test_ruuvi_library_simd_non_finite (void)
+{
+    TEST_ASSERT (0 < for_each_level (&check_non_finite));
+}
+
+static float m_scalar_rms;
+static float m_scalar_variance;
+static float m_scalar_peak2peak;
+
+static void check_long (const rl_simd_level_t level)
+{
+    const float rms = rl_rms (long_vector, LONG_LENGTH);
+    const float variance = rl_variance (long_vector, LONG_LENGTH);
+    const float peak2peak = rl_peak2peak (long_vector, LONG_LENGTH);
+
+    if (RL_SIMD_SCALAR == level)
+    {
+        m_scalar_rms = rms;
+        m_scalar_variance = variance;
+        m_scalar_peak2peak = peak2peak;
+    }
+
+    // Documented bound: n * FLT_EPSILON relative difference to scalar level.
+    TEST_ASSERT_FLOAT_WITHIN (LONG_LENGTH * FLT_EPSILON * m_scalar_rms, m_scalar_rms, rms);
+    TEST_ASSERT_FLOAT_WITHIN (LONG_LENGTH * FLT_EPSILON * m_scalar_variance,
+                              m_scalar_variance, variance);
+    TEST_ASSERT (m_scalar_peak2peak == peak2peak);
+}
+
+void test_ruuvi_library_simd_long_matches_scalar (void)
+{
+    TEST_ASSERT (0 < for_each_level (&check_long));
+}
+
+void test_ruuvi_library_simd_select_invalid (void)
+{
+    TEST_ASSERT (RL_SUCCESS == rl_simd_select (RL_SIMD_SCALAR));
+    TEST_ASSERT (RL_SIMD_SCALAR == rl_simd_level());
+    TEST_ASSERT (RL_ERROR_INTERNAL == rl_simd_select ( (rl_simd_level_t) (RL_SIMD_NEON + 1)));
+#if !defined (__aarch64__)
+    TEST_ASSERT (RL_ERROR_INTERNAL == rl_simd_select (RL_SIMD_NEON));
+#endif
+}
+
+static double m_reference_rms;
+static double m_reference_variance;
+
+static void check_pairwise (const rl_simd_level_t level)
+{
+    (void) level;
+    const float rms = rl_rms (huge_vector, HUGE_LENGTH);
+    const float variance = rl_variance (huge_vector, HUGE_LENGTH);
+    // Error no longer grows with length, bound relative to result does not include n.
+    TEST_ASSERT (fabs (rms - m_reference_rms) <= (64.0 * FLT_EPSILON * m_reference_rms));
+    TEST_ASSERT (fabs (variance - m_reference_variance)
+                 <= (1e-3 * m_reference_variance));
+}
+
+void test_ruuvi_library_simd_pairwise_accuracy (void)
+{
+    double sum = 0;
+    double square_sum = 0;
+    double deviation_sum = 0;
+
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        huge_vector[ii] = 101325.0F + (0.5F * sinf (ii * 0.001F));
+        sum += huge_vector[ii];
+        square_sum += (double) huge_vector[ii] * huge_vector[ii];
+    }
+
+    const double mean = sum / HUGE_LENGTH;
+
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        deviation_sum += (huge_vector[ii] - mean) * (huge_vector[ii] - mean);
+    }
+
+    m_reference_rms = sqrt (square_sum / HUGE_LENGTH);
+    m_reference_variance = deviation_sum / HUGE_LENGTH;
+    TEST_ASSERT (RL_SIMD_ACCUMULATE_PAIRWISE == rl_simd_accumulation());
+    TEST_ASSERT (0 < for_each_level (&check_pairwise));
+}
+
+static void check_strided (const rl_simd_level_t level)
+{
+    (void) level;
+    const float rms = rl_rms (strided_source, STRIDED_LENGTH);
+    const float variance = rl_variance (strided_source, STRIDED_LENGTH);
+    const float strided_rms = rl_rms_strided (huge_vector, STRIDED_LENGTH, 2);
+    const float strided_variance = rl_variance_strided (huge_vector, STRIDED_LENGTH, 2);
+    // Strided blocks are accumulated like contiguous ones, same bound for every stride.
+    TEST_ASSERT (fabs (strided_rms - m_reference_rms) <= (64.0 * FLT_EPSILON * m_reference_rms));
+    TEST_ASSERT (fabs (strided_variance - m_reference_variance)
+                 <= (1e-4 * m_reference_variance));
+    TEST_ASSERT (fabs (strided_rms - rms) <= (64.0 * FLT_EPSILON * rms));
+    TEST_ASSERT (fabs (strided_variance - variance) <= (1e-4 * variance));
+}
+
+void test_ruuvi_library_simd_strided_accuracy (void)
+{
+    double sum = 0;
+    double square_sum = 0;
+    double deviation_sum = 0;
+
+    for (size_t ii = 0; ii < STRIDED_LENGTH; ii++)
+    {
+        strided_source[ii] = 1.03F + (0.02F * sinf (ii * 0.001F));
+        huge_vector[2U * ii] = strided_source[ii];
+        huge_vector[ (2U * ii) + 1U] = NAN;
+        sum += strided_source[ii];
+        square_sum += (double) strided_source[ii] * strided_source[ii];
+    }
+
+    const double mean = sum / STRIDED_LENGTH;
+
+    for (size_t ii = 0; ii < STRIDED_LENGTH; ii++)
+    {
+        deviation_sum += (strided_source[ii] - mean) * (strided_source[ii] - mean);
+    }
+
+    m_reference_rms = sqrt (square_sum / STRIDED_LENGTH);
+    m_reference_variance = deviation_sum / STRIDED_LENGTH;
+    TEST_ASSERT (0 < for_each_level (&check_strided));
+}
+
+static void check_short_float (const rl_simd_level_t level)
+{
+    (void) level;
+    // Up to one block both modes run the same kernel.
+    TEST_ASSERT (RL_SUCCESS == rl_simd_accumulation_select (RL_SIMD_ACCUMULATE_PAIRWISE));
+    const float rms = rl_rms (long_vector, RL_SIMD_BLOCK_LENGTH);
+    const float variance = rl_variance (long_vector, RL_SIMD_BLOCK_LENGTH);
+    TEST_ASSERT (RL_SUCCESS == rl_simd_accumulation_select (RL_SIMD_ACCUMULATE_FLOAT));
+    TEST_ASSERT (RL_SIMD_ACCUMULATE_FLOAT == rl_simd_accumulation());
+    TEST_ASSERT (rms == rl_rms (long_vector, RL_SIMD_BLOCK_LENGTH));
+    TEST_ASSERT (variance == rl_variance (long_vector, RL_SIMD_BLOCK_LENGTH));
+}
+
+void test_ruuvi_library_simd_accumulation_short_same (void)
+{
+    TEST_ASSERT (0 < for_each_level (&check_short_float));
+}
+
+void test_ruuvi_library_simd_accumulation_invalid (void)
+{
+    TEST_ASSERT (RL_ERROR_INTERNAL == rl_simd_accumulation_select (
+                     (rl_simd_accumulation_t) (RL_SIMD_ACCUMULATE_FLOAT + 1)));
+    TEST_ASSERT (RL_SIMD_ACCUMULATE_PAIRWISE == rl_simd_accumulation());
+}
+
+/**
+ * @brief Compare integer kernels of current level with plain loop over first length counts.
+ */
+static void check_i16_prefix (const size_t length)
+{
+    int64_t expected_sum = 0;
+    uint64_t expected_square_sum = 0;
+    int16_t expected_min = counts[0];
+    int16_t expected_max = counts[0];
+    int64_t sum = 0;
+    uint64_t square_sum = 0;
+    int16_t min = 0;
+    int16_t max = 0;
+
+    for (size_t ii = 0; ii < length; ii++)
+    {
+        expected_sum += counts[ii];
+        expected_square_sum += (uint64_t) ( (int64_t) counts[ii] * counts[ii]);
+        expected_min = (counts[ii] < expected_min) ? counts[ii] : expected_min;
+        expected_max = (counts[ii] > expected_max) ? counts[ii] : expected_max;
+    }
+
+    rl_simd_sum_i16 (counts, length, &sum, &square_sum);
+    rl_simd_min_max_i16 (counts, length, &min, &max);
+    TEST_ASSERT (expected_sum == sum);
+    TEST_ASSERT (expected_square_sum == square_sum);
+    TEST_ASSERT (expected_min == min);
+    TEST_ASSERT (expected_max == max);
+}
+
+static void check_i16 (const rl_simd_level_t level)
+{
+    (void) level;
+
+    for (size_t length = 1; length <= MAX_LENGTH; length++)
+    {
+        check_i16_prefix (length);
+    }
+
+    // Several blocks of 32-bit lane sums.
+    check_i16_prefix (HUGE_LENGTH);
+}
+
+void test_ruuvi_library_simd_i16 (void)
+{
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        counts[ii] = (int16_t) ( ( (ii * 7919U) % 65536U) - 32768);
+    }
+
+    TEST_ASSERT (0 < for_each_level (&check_i16));
+}
+
+void test_ruuvi_library_simd_i16_full_scale (void)
+{
+    // Pairs of INT16_MIN squares reach 2^31 in multiply-add.
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        counts[ii] = INT16_MIN;
+    }
+
+    TEST_ASSERT (0 < for_each_level (&check_i16));
+
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        counts[ii] = (ii & 1U) ? INT16_MAX : INT16_MIN;
+    }
+
+    TEST_ASSERT (0 < for_each_level (&check_i16));
+}
@@ -0,0 +1,272 @@
+#include "unity.h"
+
+#include "ruuvi_library.h"
+#include "ruuvi_library_peak2peak.h"
+#include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_stats.h"
+#include "ruuvi_library_variance.h"
+
+#include <float.h>
+#include <math.h>
+
+#define LONG_LENGTH (4096U) //!< Samples in long comparison vector.
+#define HUGE_LENGTH (1000003U) //!< Rows in accuracy test, not whole blocks.
+
+static float long_vector[LONG_LENGTH];
+static float huge_vector[HUGE_LENGTH];
+static float huge_interleaved[2U * HUGE_LENGTH];
+
+void setUp (void)
+{
+    for (size_t ii = 0; ii < LONG_LENGTH; ii++)
+    {
+        long_vector[ii] = 101325.0F + (25.0F * sinf (ii * 0.01F)) + (float) ( (ii * 31U) % 7U);
+    }
+}
+
+void tearDown (void)
+{
+    rl_simd_accumulation_select (RL_SIMD_ACCUMULATE_PAIRWISE);
+}
+
+const float nan_test_vector[] = {0.0F, 1.0F, -1.0F, NAN, 25.0F};
+const float inf_test_vector[] = {0.0F, 1.0F, -1.0F, INFINITY, 25.0F};
+const float overflow_test_vector[] = {0.02F, 0.05F, FLT_MAX, 0 - FLT_MAX, 0.0F};
+const float valid_test_vector[] = {0.0F, 1.0F, -1.0F, 50.0F, 25.0F};
+const float negative_test_vector[] = {-3.0F, -1.0F, -2.0F};
+
+static void assert_invalid (const rl_stats_t * const stats)
+{
+    TEST_ASSERT (isnan (stats->mean));
+    TEST_ASSERT (isnan (stats->variance));
+    TEST_ASSERT (isnan (stats->rms));
+    TEST_ASSERT (isnan (stats->min));
+    TEST_ASSERT (isnan (stats->max));
+    TEST_ASSERT (isnan (stats->peak2peak));
+}
+
+void test_ruuvi_library_stats_ok (void)
+{
+    rl_stats_t stats;
+    const size_t length = sizeof (valid_test_vector) / sizeof (valid_test_vector[0]);
+    TEST_ASSERT (RL_SUCCESS == rl_stats (valid_test_vector, length, &stats));
+    TEST_ASSERT_EQUAL_FLOAT (15.0F, stats.mean);
+    TEST_ASSERT_EQUAL_FLOAT (rl_variance (valid_test_vector, length), stats.variance);
+    TEST_ASSERT_EQUAL_FLOAT (rl_rms (valid_test_vector, length), stats.rms);
+    TEST_ASSERT_EQUAL_FLOAT (-1.0F, stats.min);
+    TEST_ASSERT_EQUAL_FLOAT (50.0F, stats.max);
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (valid_test_vector, length), stats.peak2peak);
+}
+
+void test_ruuvi_library_stats_negative (void)
+{
+    rl_stats_t stats;
+    const size_t length = sizeof (negative_test_vector) / sizeof (negative_test_vector[0]);
+    TEST_ASSERT (RL_SUCCESS == rl_stats (negative_test_vector, length, &stats));
+    TEST_ASSERT_EQUAL_FLOAT (-1.0F, stats.max);
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, stats.peak2peak);
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (negative_test_vector, length), stats.peak2peak);
+}
+
+void test_ruuvi_library_stats_long_offset (void)
+{
+    rl_stats_t stats;
+    TEST_ASSERT (RL_SUCCESS == rl_stats (long_vector, LONG_LENGTH, &stats));
+    const float variance = rl_variance (long_vector, LONG_LENGTH);
+    TEST_ASSERT_FLOAT_WITHIN (variance * 1e-3F, variance, stats.variance);
+    TEST_ASSERT_EQUAL_FLOAT (rl_rms (long_vector, LONG_LENGTH), stats.rms);
+    TEST_ASSERT_EQUAL_FLOAT (rl_peak2peak (long_vector, LONG_LENGTH), stats.peak2peak);
+}
+
+void test_ruuvi_library_stats_nan_input (void)
+{
+    rl_stats_t stats;
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_stats (nan_test_vector, 5, &stats));
+    assert_invalid (&stats);
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_stats (inf_test_vector, 5, &stats));
+    assert_invalid (&stats);
+}
+
+void test_ruuvi_library_stats_overflow (void)
+{
+    rl_stats_t stats;
+    TEST_ASSERT (RL_SUCCESS == rl_stats (overflow_test_vector, 5, &stats));
+    TEST_ASSERT (isnan (stats.variance));
+    TEST_ASSERT (isnan (stats.rms));
+    TEST_ASSERT (isnan (stats.peak2peak));
+    TEST_ASSERT (isnan (rl_variance (overflow_test_vector, 5)));
+    TEST_ASSERT (isnan (rl_rms (overflow_test_vector, 5)));
+    TEST_ASSERT (isnan (rl_peak2peak (overflow_test_vector, 5)));
+    TEST_ASSERT_EQUAL_FLOAT (FLT_MAX, stats.max);
+}
+
+void test_ruuvi_library_stats_input_check (void)
+{
+    rl_stats_t stats;
+    TEST_ASSERT (RL_ERROR_NULL == rl_stats (valid_test_vector, 5, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_stats (NULL, 5, &stats));
+    assert_invalid (&stats);
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats (valid_test_vector, 0, &stats));
+    assert_invalid (&stats);
+}
+
+/** @brief Same layout as rl_data_t, without pulling compression into the test. */
+typedef struct
+{
+    uint32_t time;
+    float payload[3];
+} sample_t;
+
+#define SAMPLES (1000U) //!< Rows in interleaved tests.
+
+static sample_t samples[SAMPLES];
+static float axes[3][SAMPLES];
+
+static void samples_fill (void)
+{
+    for (size_t ii = 0; ii < SAMPLES; ii++)
+    {
+        samples[ii].time = (uint32_t) ii;
+
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            const float value = ( (axis + 1.0F) * sinf (ii * 0.02F * (axis + 1.0F)))
+                                + ( (axis == 2) ? 1.0F : 0.0F);
+            samples[ii].payload[axis] = value;
+            axes[axis][ii] = value;
+        }
+    }
+}
+
+static void assert_same (const rl_stats_t * const expected, const rl_stats_t * const stats)
+{
+    TEST_ASSERT_EQUAL_FLOAT (expected->mean, stats->mean);
+    TEST_ASSERT_EQUAL_FLOAT (expected->variance, stats->variance);
+    TEST_ASSERT_EQUAL_FLOAT (expected->rms, stats->rms);
+    TEST_ASSERT (expected->min == stats->min);
+    TEST_ASSERT (expected->max == stats->max);
+    TEST_ASSERT (expected->peak2peak == stats->peak2peak);
+}
+
+void test_ruuvi_library_stats_strided (void)
+{
+    const size_t stride = sizeof (sample_t) / sizeof (float);
+    rl_stats_t expected;
+    rl_stats_t stats;
+    samples_fill();
+
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_stats (axes[axis], SAMPLES, &expected));
+        TEST_ASSERT (RL_SUCCESS == rl_stats_strided (&samples[0].payload[axis], SAMPLES, stride,
+                     &stats));
+        assert_same (&expected, &stats);
+    }
+}
+
+void test_ruuvi_library_stats_interleaved (void)
+{
+    const size_t stride = sizeof (sample_t) / sizeof (float);
+    rl_stats_t expected;
+    rl_stats_t stats[3];
+    samples_fill();
+    TEST_ASSERT (RL_SUCCESS == rl_stats_interleaved (samples[0].payload, SAMPLES, stride, 3,
+                 stats));
+
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        TEST_ASSERT (RL_SUCCESS == rl_stats (axes[axis], SAMPLES, &expected));
+        assert_same (&expected, &stats[axis]);
+    }
+}
+
+void test_ruuvi_library_stats_interleaved_nan_channel (void)
+{
+    const size_t stride = sizeof (sample_t) / sizeof (float);
+    rl_stats_t expected;
+    rl_stats_t stats[3];
+    samples_fill();
+    samples[SAMPLES / 2].payload[1] = NAN;
+    TEST_ASSERT (RL_ERROR_NO_DATA == rl_stats_interleaved (samples[0].payload, SAMPLES, stride,
+                 3, stats));
+    assert_invalid (&stats[1]);
+    TEST_ASSERT (RL_SUCCESS == rl_stats (axes[2], SAMPLES, &expected));
+    assert_same (&expected, &stats[2]);
+}
+
+void test_ruuvi_library_stats_strided_input_check (void)
+{
+    rl_stats_t stats[RL_STATS_MAX_CHANNELS + 1];
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats_strided (valid_test_vector, 5, 0, stats));
+    assert_invalid (&stats[0]);
+    TEST_ASSERT (RL_ERROR_NULL == rl_stats_strided (NULL, 5, 1, stats));
+    TEST_ASSERT (RL_ERROR_NULL == rl_stats_interleaved (valid_test_vector, 1, 5, 5, NULL));
+    TEST_ASSERT (RL_ERROR_NULL == rl_stats_interleaved (NULL, 1, 5, 5, stats));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats_interleaved (valid_test_vector, 1, 4, 5,
+                 stats));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats_interleaved (valid_test_vector, 1, 5, 0,
+                 stats));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats_interleaved (valid_test_vector, 0, 5, 5,
+                 stats));
+    TEST_ASSERT (RL_ERROR_DATA_LENGTH == rl_stats_interleaved (valid_test_vector, 1,
+                 RL_STATS_MAX_CHANNELS + 1, RL_STATS_MAX_CHANNELS + 1, stats));
+    assert_invalid (&stats[4]);
+}
+
+void test_ruuvi_library_stats_long_accuracy (void)
+{
+    const size_t stride = 2U;
+    double sum = 0;
+    double square_sum = 0;
+    double deviation_sum = 0;
+    rl_stats_t stats;
+    rl_stats_t channels[2];
+
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        huge_vector[ii] = 1.03F + (0.02F * sinf (ii * 0.001F));
+        huge_interleaved[stride * ii] = huge_vector[ii];
+        huge_interleaved[ (stride * ii) + 1U] = -huge_vector[ii];
+        sum += huge_vector[ii];
+        square_sum += (double) huge_vector[ii] * huge_vector[ii];
+    }
+
+    const double mean = sum / HUGE_LENGTH;
+
+    for (size_t ii = 0; ii < HUGE_LENGTH; ii++)
+    {
+        deviation_sum += (huge_vector[ii] - mean) * (huge_vector[ii] - mean);
+    }
+
+    const double rms = sqrt (square_sum / HUGE_LENGTH);
+    const double variance = deviation_sum / HUGE_LENGTH;
+    TEST_ASSERT (RL_SUCCESS == rl_stats (huge_vector, HUGE_LENGTH, &stats));
+    // Blocks keep the error independent of length.
+    TEST_ASSERT (fabs (stats.rms - rms) <= (64.0 * FLT_EPSILON * rms));
+    TEST_ASSERT (fabs (stats.mean - mean) <= (64.0 * FLT_EPSILON * mean));
+    TEST_ASSERT (fabs (stats.variance - variance) <= (1e-4 * variance));
+    // Every stride and channel count sums the same blocks.
+    TEST_ASSERT (RL_SUCCESS == rl_stats_interleaved (huge_interleaved, HUGE_LENGTH, stride, 2,
+                 channels));
+    assert_same (&stats, &channels[0]);
+    TEST_ASSERT_EQUAL_FLOAT (stats.rms, channels[1].rms);
+    TEST_ASSERT_EQUAL_FLOAT (stats.variance, channels[1].variance);
+}
+
+void test_ruuvi_library_stats_accumulation_float (void)
+{
+    rl_stats_t pairwise;
+    rl_stats_t single;
+    rl_stats_t stats;
+    TEST_ASSERT (RL_SUCCESS == rl_stats (long_vector, LONG_LENGTH, &pairwise));
+    TEST_ASSERT (RL_SUCCESS == rl_stats (long_vector, RL_SIMD_BLOCK_LENGTH, &single));
+    TEST_ASSERT (RL_SUCCESS == rl_simd_accumulation_select (RL_SIMD_ACCUMULATE_FLOAT));
+    // Up to one block both modes sum the same way, longer inputs follow the mode.
+    TEST_ASSERT (RL_SUCCESS == rl_stats (long_vector, RL_SIMD_BLOCK_LENGTH, &stats));
+    assert_same (&single, &stats);
+    TEST_ASSERT (RL_SUCCESS == rl_stats (long_vector, LONG_LENGTH, &stats));
+    TEST_ASSERT (pairwise.rms != stats.rms);
+    TEST_ASSERT_FLOAT_WITHIN (LONG_LENGTH * FLT_EPSILON * pairwise.rms, pairwise.rms,
+                              stats.rms);
+}
@@ -0,0 +1,99 @@
+#include "unity.h"
+
+#include "ruuvi_library_simd.h"
+#include "ruuvi_library_variance.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define LONG_LENGTH (10000U) //!< Samples in long comparison vector.
+
+static int16_t long_i16[LONG_LENGTH];
+static int32_t long_i32[LONG_LENGTH];
+
+void setUp (void)
+{
+    // Accelerometer-like counts around 1 g with noise.
+    for (size_t ii = 0; ii < LONG_LENGTH; ii++)
+    {
+        long_i16[ii] = (int16_t) (16384 + (int32_t) ( (ii * 7919U) % 201U) - 100);
+        long_i32[ii] = 8000000 + (int32_t) ( (ii * 7919U) % 201U) - 100;
+    }
+}
+
+void tearDown (void)
+{
+}
+
+const float valid_test_vector[] = {0.0F, 1.0F, -1.0F, 50.0F, 25.0F};
+const int16_t valid_i16_vector[] = {0, 1, -1, 50, 25};
+const int32_t valid_i32_vector[] = {0, 1, -1, 50, 25};
+
+/**
+ * @brief Exact variance of counts with double sums.
+ */
+static double reference_variance (const double sum, const double square_sum)
+{
+    const double mean = sum / LONG_LENGTH;
+    return (square_sum / LONG_LENGTH) - (mean * mean);
+}
+
+void test_ruuvi_library_variance_i16_ok (void)
+{
+    TEST_ASSERT_EQUAL_FLOAT (rl_variance (valid_test_vector, 5),
+                             rl_variance_i16 (valid_i16_vector, 5));
+}
+
+void test_ruuvi_library_variance_i32_ok (void)
+{
+    TEST_ASSERT_EQUAL_FLOAT (rl_variance (valid_test_vector, 5),
+                             rl_variance_i32 (valid_i32_vector, 5));
+}
+
+void test_ruuvi_library_variance_integer_offset (void)
+{
+    double sum = 0;
+    double square_sum = 0;
+
+    for (size_t ii = 0; ii < LONG_LENGTH; ii++)
+    {
+        const double delta = long_i16[ii] - 16384;
+        sum += delta;
+        square_sum += delta * delta;
+    }
+
+    const double expected = reference_variance (sum, square_sum);
+    TEST_ASSERT_EQUAL_FLOAT ( (float) expected, rl_variance_i16 (long_i16, LONG_LENGTH));
+    // Same deviations at a 24-bit offset.
+    TEST_ASSERT_EQUAL_FLOAT ( (float) expected, rl_variance_i32 (long_i32, LONG_LENGTH));
+}
+
+void test_ruuvi_library_variance_integer_extremes (void)
+{
+    const int16_t i16_extremes[] = {INT16_MAX, INT16_MIN};
+    const int32_t i32_extremes[] = {INT32_MAX, INT32_MIN};
+    const int16_t constant[] = {-7, -7, -7};
+    TEST_ASSERT_EQUAL_FLOAT (32767.5F * 32767.5F, rl_variance_i16 (i16_extremes, 2));
+    TEST_ASSERT_EQUAL_FLOAT (2147483647.5F * 2147483647.5F, rl_variance_i32 (i32_extremes, 2));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, rl_variance_i16 (constant, 3));
+}
+
+void test_ruuvi_library_variance_integer_invalid (void)
+{
+    TEST_ASSERT (isnan (rl_variance_i16 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_variance_i16 (valid_i16_vector, 0)));
+    TEST_ASSERT (isnan (rl_variance_i32 (NULL, 5)));
+    TEST_ASSERT (isnan (rl_variance_i32 (valid_i32_vector, 0)));
+}
+
+void test_ruuvi_library_variance_strided (void)
+{
+    const float interleaved[] = {0.0F, NAN, 1.0F, NAN, -1.0F, NAN, 50.0F, NAN, 25.0F};
+    TEST_ASSERT_EQUAL_FLOAT (rl_variance (valid_test_vector, 5),
+                             rl_variance_strided (interleaved, 5, 2));
+    TEST_ASSERT (isnan (rl_variance_strided (&interleaved[1], 4, 2)));
+    TEST_ASSERT (rl_variance (valid_test_vector, 5)
+                 == rl_variance_strided (valid_test_vector, 5, 1));
+    TEST_ASSERT (isnan (rl_variance_strided (valid_test_vector, 5, 0)));
+    TEST_ASSERT (isnan (rl_variance_strided (NULL, 5, 2)));
+}
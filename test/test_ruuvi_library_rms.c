@@ -1,6 +1,7 @@
 #include "unity.h"
 
 #include "ruuvi_library_rms.h"
+#include "ruuvi_library_simd.h"
 
 #include <math.h>
 